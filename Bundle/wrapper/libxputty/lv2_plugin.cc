@@ -19,8 +19,15 @@
  */
 
 
+#include <time.h>
+
 #include "lv2_plugin.h"
 
+// host values are applied to the widgets at most this often per second
+#ifndef UI_FRAME_RATE
+#define UI_FRAME_RATE 60
+#endif
+
 /*---------------------------------------------------------------------
 -----------------------------------------------------------------------    
                 the main LV2 handle->XWindow
@@ -314,10 +321,58 @@ void load_bg_image(X11_UI* ui, const char* image) {
     cairo_destroy(cri);
 }
 
+// sliced frames of a horizontal sprite strip, stored as user data on the widget surface
+typedef struct {
+    cairo_surface_t **frame;
+    int count;
+    bool is_slider;
+    xevfunc expose;
+    // the strip the frames were cut from
+    cairo_surface_t *image;
+    int width;
+    int height;
+} SpriteFrames;
+
+static cairo_user_data_key_t sprite_frames_key;
+
+static void sprite_frames_destroy(void *data) {
+    SpriteFrames *sprites = (SpriteFrames*)data;
+    int i = 0;
+    for (;i<sprites->count;i++) {
+        cairo_surface_destroy(sprites->frame[i]);
+    }
+    free(sprites->frame);
+    free(sprites);
+}
+
+// hand only the frame matching the adjustment state to the widget draw function
+static void draw_sprite_frame(void *w_, void* user_data) {
+    Widget_t *w = (Widget_t*)w_;
+    SpriteFrames *sprites = (SpriteFrames*)cairo_surface_get_user_data(w->surface, &sprite_frames_key);
+    // the frames went with the surface, the original expose went with them
+    if (!sprites) return;
+    int findex = (int)((sprites->count-1) * adj_get_state(w->adj));
+    cairo_surface_t *strip = w->image;
+    w->image = sprites->frame[findex];
+    if (sprites->is_slider) set_slider_image_frame_count(w, 1);
+    sprites->expose(w_, user_data);
+    if (sprites->is_slider) set_slider_image_frame_count(w, sprites->count);
+    w->image = strip;
+}
+
+// forget the frames of a replaced image and draw the widget the normal way again
+static void drop_sprite_frames(Widget_t* w) {
+    SpriteFrames *sprites = (SpriteFrames*)cairo_surface_get_user_data(w->surface, &sprite_frames_key);
+    if (!sprites) return;
+    w->func.expose_callback = sprites->expose;
+    cairo_surface_set_user_data(w->surface, &sprite_frames_key, NULL, NULL);
+}
+
 void load_controller_image(Widget_t* w, const char* image) {
     cairo_surface_t *getpng = cairo_image_surface_create_from_png (image);
     int width = cairo_image_surface_get_width(getpng);
     int height = cairo_image_surface_get_height(getpng);
+    drop_sprite_frames(w);
     cairo_surface_destroy(w->image);
     w->image = NULL;
 
@@ -330,6 +385,166 @@ void load_controller_image(Widget_t* w, const char* image) {
     cairo_destroy(cri);
 }
 
+void slice_controller_image(Widget_t* w, int count) {
+    if (!w->image) return;
+    int width = cairo_xlib_surface_get_width(w->image);
+    int height = cairo_xlib_surface_get_height(w->image);
+    bool is_slider = count > 0;
+    if (!is_slider) count = width/max(1,height);
+    SpriteFrames *cached = (SpriteFrames*)cairo_surface_get_user_data(w->surface, &sprite_frames_key);
+    if (cached && cached->image == w->image && cached->width == width &&
+            cached->height == height && cached->count == count &&
+            cached->is_slider == is_slider) return;
+    drop_sprite_frames(w);
+    if (count < 2 || width < count) return;
+    int frame_width = width/count;
+    SpriteFrames *sprites = (SpriteFrames*)malloc(sizeof(SpriteFrames));
+    sprites->frame = (cairo_surface_t **)malloc(count * sizeof(cairo_surface_t *));
+    int i = 0;
+    for (;i<count;i++) {
+        sprites->frame[i] = cairo_surface_create_similar (w->surface, 
+                            CAIRO_CONTENT_COLOR_ALPHA, frame_width, height);
+        cairo_t *cri = cairo_create (sprites->frame[i]);
+        cairo_set_source_surface (cri, w->image, -frame_width*i, 0);
+        cairo_paint (cri);
+        cairo_destroy(cri);
+    }
+    sprites->count = count;
+    sprites->is_slider = is_slider;
+    sprites->expose = w->func.expose_callback;
+    sprites->image = w->image;
+    sprites->width = width;
+    sprites->height = height;
+    cairo_surface_set_user_data(w->surface, &sprite_frames_key, sprites, sprite_frames_destroy);
+    w->func.expose_callback = draw_sprite_frame;
+}
+
+static cairo_user_data_key_t image_data_key;
+
+// wrap embedded pixels in a cairo surface, run length encoded images get decoded once
+cairo_surface_t *surface_from_image_data(CairoImageData *image) {
+    if (!image->rle) {
+        return cairo_image_surface_create_for_data(image->data, CAIRO_FORMAT_ARGB32,
+                                        image->width, image->height, image->stride);
+    }
+    size_t count = (size_t)(image->stride/4) * image->height;
+    uint32_t *px = (uint32_t*)malloc(count * sizeof(uint32_t));
+    size_t o = 0;
+    unsigned int i = 0;
+    while (i < image->rle_len && o < count) {
+        unsigned int n = image->rle[i] & 0x7fffffff;
+        if (n > count - o) n = count - o;
+        if (image->rle[i++] & 0x80000000) {
+            uint32_t p = image->rle[i++];
+            unsigned int j = 0;
+            for (;j<n;j++) px[o++] = p;
+        } else {
+            memcpy(&px[o], &image->rle[i], n * sizeof(uint32_t));
+            o += n;
+            i += n;
+        }
+    }
+    if (o < count) memset(&px[o], 0, (count - o) * sizeof(uint32_t));
+    cairo_surface_t *surface = cairo_image_surface_create_for_data((unsigned char*)px,
+                CAIRO_FORMAT_ARGB32, image->width, image->height, image->stride);
+    cairo_surface_set_user_data(surface, &image_data_key, px, free);
+    return surface;
+}
+
+// paint embedded pixels into the widget image, scaled to the widget size when asked
+void load_image_data(Widget_t* w, CairoImageData *image, bool scaled) {
+    cairo_surface_t *pixels = surface_from_image_data(image);
+    int width_t = scaled ? w->scale.init_width : image->width;
+    int height_t = scaled ? w->scale.init_height : image->height;
+    drop_sprite_frames(w);
+    cairo_surface_destroy(w->image);
+    w->image = NULL;
+
+    w->image = cairo_surface_create_similar (w->surface, 
+                        CAIRO_CONTENT_COLOR_ALPHA, width_t, height_t);
+    cairo_t *cri = cairo_create (w->image);
+    if (scaled) cairo_scale(cri, (double)width_t/(double)image->width,
+                                    (double)height_t/(double)image->height);
+    cairo_set_source_surface (cri, pixels,0,0);
+    cairo_paint (cri);
+    cairo_surface_destroy(pixels);
+    cairo_destroy(cri);
+}
+
+// paint one frame of an atlas page into the widget image
+void load_atlas_image(Widget_t* w, cairo_surface_t **atlas, const AtlasFrame *frame, bool scaled) {
+    int width_t = scaled ? w->scale.init_width : frame->width;
+    int height_t = scaled ? w->scale.init_height : frame->height;
+    drop_sprite_frames(w);
+    cairo_surface_destroy(w->image);
+    w->image = NULL;
+
+    w->image = cairo_surface_create_similar (w->surface, 
+                        CAIRO_CONTENT_COLOR_ALPHA, width_t, height_t);
+    cairo_t *cri = cairo_create (w->image);
+    if (scaled) cairo_scale(cri, (double)width_t/(double)frame->width,
+                                    (double)height_t/(double)frame->height);
+    cairo_set_source_surface (cri, atlas[frame->page], -frame->x, -frame->y);
+    cairo_rectangle(cri, 0, 0, frame->width, frame->height);
+    cairo_fill (cri);
+    cairo_destroy(cri);
+}
+
+// walk the table instead of a generated call sequence for each widget
+void create_widget_table(X11_UI *ui, const WidgetTable *table, cairo_surface_t **atlas,
+                                                            int page, float scale) {
+    int i = 0;
+    for (;i<table->widget_count;i++) {
+        const WidgetDescriptor *d = &table->widgets[i];
+        if (d->page != page) continue;
+        Widget_t *p = d->parent < 0 ? ui->win : d->tab ?
+                        ui->tab_elem[d->parent] : ui->elem[d->parent];
+        Widget_t *w = d->add(ui->widget[i], p, d->port, d->label, ui,
+                        d->x, d->y, d->width * scale, d->height * scale);
+        ui->widget[i] = w;
+        if (d->image >= 0 && atlas) {
+            load_atlas_image(w, atlas, &table->frames[d->image], false);
+            if (d->sprites > 0) set_slider_image_frame_count(w, d->sprites);
+            if (d->sprites >= 0) slice_controller_image(w, d->sprites);
+        }
+        if (d->entries) {
+            const char *const *e = d->entries;
+            for (;*e;e++) combobox_add_entry(w, *e);
+        }
+        if (d->range) {
+            set_adjustment(w->adj, d->std_value, d->std_value, d->min_value,
+                            d->max_value, d->step, d->adj_type);
+        }
+    }
+    for (i=0;i<table->color_count;i++) {
+        const ColorDescriptor *c = &table->colors[i];
+        if (table->widgets[c->widget].page != page || !ui->widget[c->widget]) continue;
+        set_widget_color(ui->widget[c->widget], (Color_state)c->state, (Color_mod)c->mod,
+                                                        c->r, c->g, c->b, c->a);
+    }
+}
+
+// chain the widgets by the port they listen to, so port_event() finds them directly
+static void create_port_map(X11_UI* ui) {
+    int i = 0;
+    ui->port_count = 0;
+    for (;i<CONTROLS;i++) {
+        if (ui->widget[i] && ui->widget[i]->data >= ui->port_count)
+            ui->port_count = ui->widget[i]->data + 1;
+    }
+    free(ui->port_first);
+    ui->port_first = (int*)malloc(max(1, ui->port_count) * sizeof(int));
+    for (i=0;i<ui->port_count;i++)
+        ui->port_first[i] = -1;
+    // walk backwards to keep the widget order within a port
+    for (i=CONTROLS-1;i>=0;i--) {
+        ui->port_next[i] = -1;
+        if (!ui->widget[i] || ui->widget[i]->data < 0) continue;
+        ui->port_next[i] = ui->port_first[ui->widget[i]->data];
+        ui->port_first[ui->widget[i]->data] = i;
+    }
+}
+
 // init the xwindow and return the LV2UI handle
 static LV2UI_Handle instantiate(const LV2UI_Descriptor * descriptor,
             const char * plugin_uri, const char * bundle_path,
@@ -346,14 +561,30 @@ static LV2UI_Handle instantiate(const LV2UI_Descriptor * descriptor,
 
     ui->parentXwindow = 0;
     ui->private_ptr = NULL;
+    ui->port_first = NULL;
+    ui->port_count = 0;
+    ui->dirty_count = 0;
+    ui->last_frame = 0.0;
+    ui->idle_active = 0;
+    ui->idle_skipped = 0;
     LV2_Options_Option *opts = NULL;
 
     int i = 0;
-    for(;i<CONTROLS;i++)
+    for(;i<CONTROLS;i++) {
         ui->widget[i] = NULL;
+        ui->pending[i] = false;
+    }
     i = 0;
     for(;i<GUI_ELEMENTS;i++)
         ui->elem[i] = NULL;
+#ifdef LAZY_TAB_PAGES
+    i = 0;
+    for(;i<TAB_ELEMENTS;i++)
+        ui->tab_page[i] = NULL;
+    ui->port_cache = NULL;
+    ui->port_cached = NULL;
+    ui->port_cache_size = 0;
+#endif
 
     i = 0;
     for (; features[i]; ++i) {
@@ -395,6 +626,9 @@ static LV2UI_Handle instantiate(const LV2UI_Descriptor * descriptor,
         }
         if (scale <= 0) scale = 1.0;
     }
+#ifdef LAZY_TAB_PAGES
+    ui->tab_page_scale = scale;
+#endif
 
     // init Xputty
     main_init(&ui->main);
@@ -413,6 +647,8 @@ static LV2UI_Handle instantiate(const LV2UI_Descriptor * descriptor,
     ui->win->func.expose_callback = draw_window;
     // create controller widgets
     plugin_create_controller_widgets(ui,plugin_uri, scale);
+    // lookup table for port_event()
+    create_port_map(ui);
     // map all widgets into the toplevel Widget_t
     widget_show_all(ui->win);
     // set the widget pointer to the X11 Window from the toplevel Widget_t
@@ -432,6 +668,15 @@ static LV2UI_Handle instantiate(const LV2UI_Descriptor * descriptor,
 // cleanup after usage
 static void cleanup(LV2UI_Handle handle) {
     X11_UI* ui = (X11_UI*)handle;
+    if (getenv("XUI_IDLE_STATS")) {
+        fprintf(stderr, "%s: %lu idle calls, %lu active, %lu skipped\n", ui->win->label,
+            ui->idle_active + ui->idle_skipped, ui->idle_active, ui->idle_skipped);
+    }
+    free(ui->port_first);
+#ifdef LAZY_TAB_PAGES
+    free(ui->port_cache);
+    free(ui->port_cached);
+#endif
     free(ui->kp);
     plugin_cleanup(ui);
     // Xputty free all memory used
@@ -444,6 +689,62 @@ static void null_callback(void *w_, void* user_data) {
     
 }
 
+#ifdef LAZY_TAB_PAGES
+// keep the last value of each port for the widgets which don't exist yet
+static void cache_port_value(X11_UI* ui, uint32_t port_index, float value) {
+    if (port_index >= ui->port_cache_size) {
+        uint32_t size = port_index + 16;
+        ui->port_cache = (float*)realloc(ui->port_cache, size * sizeof(float));
+        ui->port_cached = (bool*)realloc(ui->port_cached, size * sizeof(bool));
+        memset(&ui->port_cached[ui->port_cache_size], 0, (size - ui->port_cache_size) * sizeof(bool));
+        ui->port_cache_size = size;
+    }
+    ui->port_cache[port_index] = value;
+    ui->port_cached[port_index] = true;
+}
+
+// build the widgets of a tab page the first time the tabbox switches to it
+static void lazy_tab_changed(void *w_, void* user_data) {
+    Widget_t *w = (Widget_t*)w_;
+    X11_UI* ui = (X11_UI*)w->parent_struct;
+    int v = (int)adj_get_value(w->adj);
+    if (v < 0 || v >= w->childlist->elem) return;
+    Widget_t *page = w->childlist->childs[v];
+    int t = 0;
+    for (;t<TAB_ELEMENTS;t++) {
+        if (ui->tab_elem[t] == page) break;
+    }
+    if (t == TAB_ELEMENTS || !ui->tab_page[t]) return;
+    bool existed[CONTROLS];
+    int i = 0;
+    for (;i<CONTROLS;i++)
+        existed[i] = ui->widget[i] != NULL;
+    ui->tab_page[t](ui, ui->tab_page_scale);
+    ui->tab_page[t] = NULL;
+    create_port_map(ui);
+    // hand the new widgets the values the host sent before
+    for (i=0;i<CONTROLS;i++) {
+        Widget_t *wi = ui->widget[i];
+        if (existed[i] || !wi || wi->data < 0) continue;
+        if ((uint32_t)wi->data >= ui->port_cache_size || !ui->port_cached[wi->data]) continue;
+        xevfunc store = wi->func.value_changed_callback;
+        wi->func.value_changed_callback = null_callback;
+        adj_set_value(wi->adj, ui->port_cache[wi->data]);
+        wi->func.value_changed_callback = store;
+    }
+    widget_show_all(page);
+    // the new widgets were placed unscaled, let a configure run scale them like the rest
+    if (ui->win->width != ui->win->scale.init_width || ui->win->height != ui->win->scale.init_height) {
+        send_configure_event(ui->win, 0, 0, ui->win->width, ui->win->height);
+    }
+}
+
+void set_lazy_tab_page(X11_UI *ui, int tab, void (*create)(X11_UI *ui, float scale)) {
+    ui->tab_page[tab] = create;
+    ((Widget_t*)ui->tab_elem[tab]->parent)->func.value_changed_callback = lazy_tab_changed;
+}
+#endif
+
 /*---------------------------------------------------------------------
 -----------------------------------------------------------------------    
                         LV2 interface
@@ -456,25 +757,59 @@ static void port_event(LV2UI_Handle handle, uint32_t port_index,
                         const void * buffer) {
     X11_UI* ui = (X11_UI*)handle;
     float value = *(float*)buffer;
-    int i=0;
-    for (;i<CONTROLS;i++) {
-        if (ui->widget[i] && port_index == (uint32_t)ui->widget[i]->data) {
-            // prevent event loop between host and plugin
-            xevfunc store = ui->widget[i]->func.value_changed_callback;
-            ui->widget[i]->func.value_changed_callback = null_callback;
-            // Xputty check if the new value differs from the old one
-            // and set new one, when needed
-            adj_set_value(ui->widget[i]->adj, value);
-            // activate value_change_callback back
-            ui->widget[i]->func.value_changed_callback = store;
+#ifdef LAZY_TAB_PAGES
+    if (format == 0) cache_port_value(ui, port_index, value);
+#endif
+    int i = port_index < (uint32_t)ui->port_count ? ui->port_first[port_index] : -1;
+    for (;i>=0;i=ui->port_next[i]) {
+        // keep only the latest value, the widget gets redrawn on the next frame
+        ui->pending_value[i] = value;
+        if (!ui->pending[i]) {
+            ui->pending[i] = true;
+            ui->dirty[ui->dirty_count++] = i;
         }
    }
    plugin_port_event(handle, port_index, buffer_size, format, buffer);
 }
 
+static double frame_clock() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+// set the values the host sent since the last frame, one redraw per widget
+static bool flush_port_values(X11_UI* ui) {
+    double now = frame_clock();
+    if (now - ui->last_frame < 1.0 / UI_FRAME_RATE) return false;
+    ui->last_frame = now;
+    int j = 0;
+    for (;j<ui->dirty_count;j++) {
+        int i = ui->dirty[j];
+        ui->pending[i] = false;
+        // prevent event loop between host and plugin
+        xevfunc store = ui->widget[i]->func.value_changed_callback;
+        ui->widget[i]->func.value_changed_callback = null_callback;
+        // Xputty check if the new value differs from the old one
+        // and set new one, when needed
+        adj_set_value(ui->widget[i]->adj, ui->pending_value[i]);
+        // activate value_change_callback back
+        ui->widget[i]->func.value_changed_callback = store;
+    }
+    ui->dirty_count = 0;
+    return true;
+}
+
 // LV2 idle interface to host
 static int ui_idle(LV2UI_Handle handle) {
     X11_UI* ui = (X11_UI*)handle;
+    bool flushed = ui->dirty_count && flush_port_values(ui);
+    // nothing from the X server and no host values due, leave it for the next call
+    if (!flushed && !XPending(ui->main.dpy)) {
+        ui->idle_skipped++;
+        return 0;
+    }
+    ui->idle_active++;
     // Xputty event loop setup to run one cycle when called
     run_embedded(&ui->main);
     return 0;
@@ -55,8 +55,19 @@ typedef struct {
     int width;
     int height;
     unsigned char* data;
+    const unsigned int* rle;
+    unsigned int rle_len;
 } CairoImageData;
 
+// place of one image on the atlas pages of a generated UI
+typedef struct {
+    int page;
+    int x;
+    int y;
+    int width;
+    int height;
+} AtlasFrame;
+
 // struct to define the knob pattern colors
 typedef struct {
     double p1f[4];
@@ -74,7 +85,7 @@ typedef struct {
 typedef int PortIndex;
 
 // main window struct
-typedef struct {
+typedef struct X11_UI {
 #ifdef USE_MIDI
     LV2_URID midi_MidiEvent;
     LV2_URID atom_eventTransfer;
@@ -88,6 +99,27 @@ typedef struct {
     Widget_t *widget[CONTROLS];
     Widget_t *elem[GUI_ELEMENTS];
     Widget_t *tab_elem[TAB_ELEMENTS];
+    // ui->widget indices per port index, chained through port_next, -1 ends a chain
+    int *port_first;
+    int port_next[CONTROLS];
+    int port_count;
+    // host values waiting for the next frame, applied in ui_idle()
+    float pending_value[CONTROLS];
+    bool pending[CONTROLS];
+    int dirty[CONTROLS];
+    int dirty_count;
+    double last_frame;
+    // ui_idle() calls that had work to do and calls that returned right away
+    unsigned long idle_active;
+    unsigned long idle_skipped;
+#ifdef LAZY_TAB_PAGES
+    // creators for the widgets of hidden tab pages and the host values they missed
+    void (*tab_page[TAB_ELEMENTS])(struct X11_UI *ui, float scale);
+    float tab_page_scale;
+    float *port_cache;
+    bool *port_cached;
+    uint32_t port_cache_size;
+#endif
     KnobColors *kp;
     void *private_ptr;
     int need_resize;
@@ -170,6 +202,74 @@ void load_bg_image(X11_UI* ui, const char* image);
 
 void load_controller_image(Widget_t* w, const char* image);
 
+// slice a horizontal sprite strip into single frames, count 0 takes square knob frames
+void slice_controller_image(Widget_t* w, int count);
+
+// embedded images are only generated for plugin builds, test builds load the png files
+
+// image surface for embedded CairoImageData, decodes run length encoded pixels
+cairo_surface_t *surface_from_image_data(CairoImageData *image);
+
+// set the widget image from embedded pixels, without decoding a png
+void load_image_data(Widget_t* w, CairoImageData *image, bool scaled);
+
+// set the widget image from one frame of the image atlas
+void load_atlas_image(Widget_t* w, cairo_surface_t **atlas, const AtlasFrame *frame, bool scaled);
+
+typedef Widget_t* (*AddWidgetFunc)(Widget_t *w, Widget_t *p, PortIndex index, const char * label,
+                                X11_UI* ui, int x, int y, int width, int height);
+
+// one ui->widget[] of a generated layout table
+typedef struct {
+    AddWidgetFunc add;
+    int parent;             // index in ui->elem[] or ui->tab_elem[], -1 for ui->win
+    bool tab;
+    int page;               // lazy tab page, -1 when created with the window
+    PortIndex port;
+    const char *label;
+    int x;
+    int y;
+    int width;
+    int height;
+    bool range;             // set the adjustment from the values below
+    float std_value;
+    float min_value;
+    float max_value;
+    float step;
+    CL_type adj_type;
+    int image;              // index in the atlas frames, -1 for none
+    int sprites;            // slider frame count, 0 for knob frames, -1 to not slice
+    const char *const *entries;   // NULL terminated combobox entries
+} WidgetDescriptor;
+
+// a widget color differing from the theme
+typedef struct {
+    int widget;
+    int state;
+    int mod;
+    float r;
+    float g;
+    float b;
+    float a;
+} ColorDescriptor;
+
+typedef struct {
+    const WidgetDescriptor *widgets;
+    int widget_count;
+    const ColorDescriptor *colors;
+    int color_count;
+    const AtlasFrame *frames;
+} WidgetTable;
+
+// create the widgets of a layout table which belong to the given lazy tab page
+void create_widget_table(X11_UI *ui, const WidgetTable *table, cairo_surface_t **atlas,
+                                                            int page, float scale);
+
+#ifdef LAZY_TAB_PAGES
+// create the widgets of a tab page when the tabbox switches to it the first time
+void set_lazy_tab_page(X11_UI *ui, int tab, void (*create)(X11_UI *ui, float scale));
+#endif
+
 // free used mem on exit
 void plugin_cleanup(X11_UI *ui);
 
@@ -19,6 +19,9 @@
  */
 
 
+#include <poll.h>
+#include <time.h>
+
 #include "lv2_plugin.h"
 #include "xmessage-dialog.h"
 #include "xfile-dialog.h"
@@ -75,12 +78,104 @@ static void value_changed(void *w_, void* user_data) {
 }
 
 
+/*---------------------------------------------------------------------
+-----------------------------------------------------------------------    
+                draw time per widget type
+-----------------------------------------------------------------------
+----------------------------------------------------------------------*/
+
+typedef enum {
+    TEST_KNOB,
+    TEST_COMBOBOX,
+    TEST_VMETER,
+    TEST_HMETER,
+    TEST_VSLIDER,
+    TEST_HSLIDER,
+    TEST_TOGGLE_BUTTON,
+    TEST_IMAGE_TOGGLE,
+    TEST_BUTTON,
+    TEST_IMAGE_BUTTON,
+    TEST_FILE_BUTTON,
+    TEST_VALUEDISPLAY,
+    TEST_LABEL,
+    TEST_FRAME,
+    TEST_IMAGE,
+    TEST_WAVEVIEW,
+    TEST_TABBOX,
+    TEST_TAB,
+    TEST_MIDIKEYBOARD,
+    TEST_TYPES,
+} TestType;
+
+typedef struct {
+    const char *name;
+    int widgets;
+    long draws;
+    double cpu;
+} TestProfile;
+
+static TestProfile test_profile[TEST_TYPES] = {
+    {"knob"}, {"combobox"}, {"vmeter"}, {"hmeter"}, {"vslider"}, {"hslider"},
+    {"toggle_button"}, {"image_toggle"}, {"button"}, {"image_button"},
+    {"file_button"}, {"valuedisplay"}, {"label"}, {"frame"}, {"image"},
+    {"waveview"}, {"tabbox"}, {"tab"}, {"midikeyboard"},
+};
+
+// the wrapped draw function, stored as user data on the widget surface
+typedef struct {
+    TestType type;
+    xevfunc expose;
+} TestWidget;
+
+static cairo_user_data_key_t test_widget_key;
+
+// set from the command line before the widgets get created
+static bool test_profiling = false;
+
+static double test_clock(clockid_t clock) {
+    struct timespec ts;
+    clock_gettime(clock, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+// count the cpu time the widget draw function takes
+static void test_profile_expose(void *w_, void* user_data) {
+    Widget_t *w = (Widget_t*)w_;
+    TestWidget *t = (TestWidget*)cairo_surface_get_user_data(w->surface, &test_widget_key);
+    double start = test_clock(CLOCK_THREAD_CPUTIME_ID);
+    t->expose(w_, user_data);
+    test_profile[t->type].cpu += test_clock(CLOCK_THREAD_CPUTIME_ID) - start;
+    test_profile[t->type].draws++;
+}
+
+static void test_widget_destroy(void *data) {
+    TestWidget *t = (TestWidget*)data;
+    test_profile[t->type].widgets--;
+    free(t);
+}
+
+static void test_profile_widget(Widget_t *w, TestType type) {
+    if (!test_profiling || !w) return;
+    TestWidget *t = (TestWidget*)malloc(sizeof(TestWidget));
+    t->type = type;
+    t->expose = w->func.expose_callback;
+    cairo_surface_set_user_data(w->surface, &test_widget_key, t, test_widget_destroy);
+    w->func.expose_callback = test_profile_expose;
+    test_profile[type].widgets++;
+}
+
+static bool test_widget_is_meter(Widget_t *w) {
+    TestWidget *t = (TestWidget*)cairo_surface_get_user_data(w->surface, &test_widget_key);
+    return t && (t->type == TEST_VMETER || t->type == TEST_HMETER);
+}
+
 Widget_t* add_lv2_knob(Widget_t *w, Widget_t *p, PortIndex index, const char * label,
                                 X11_UI* ui, int x, int y, int width, int height) {
     w = add_knob(p, label, x, y, width, height);
     w->parent_struct = ui;
     w->data = index;
     w->func.value_changed_callback = value_changed;
+    test_profile_widget(w, TEST_KNOB);
     return w;
 }
 
@@ -91,6 +186,7 @@ Widget_t* add_lv2_combobox(Widget_t *w, Widget_t *p, PortIndex index, const char
     w->parent_struct = ui;
     w->data = index;
     w->func.value_changed_callback = value_changed;
+    test_profile_widget(w, TEST_COMBOBOX);
     return w;
 }
 
@@ -101,6 +197,7 @@ Widget_t* add_lv2_vmeter(Widget_t *w, Widget_t *p, PortIndex index, const char *
     w->parent_struct = ui;
     w->data = index;
     w->func.value_changed_callback = value_changed;
+    test_profile_widget(w, TEST_VMETER);
     return w;
 }
 
@@ -110,6 +207,7 @@ Widget_t* add_lv2_hmeter(Widget_t *w, Widget_t *p, PortIndex index, const char *
     w->parent_struct = ui;
     w->data = index;
     w->func.value_changed_callback = value_changed;
+    test_profile_widget(w, TEST_HMETER);
     return w;
 }
 
@@ -119,6 +217,7 @@ Widget_t* add_lv2_vslider(Widget_t *w, Widget_t *p, PortIndex index, const char
     w->parent_struct = ui;
     w->data = index;
     w->func.value_changed_callback = value_changed;
+    test_profile_widget(w, TEST_VSLIDER);
     return w;
 }
 
@@ -128,6 +227,7 @@ Widget_t* add_lv2_hslider(Widget_t *w, Widget_t *p, PortIndex index, const char
     w->parent_struct = ui;
     w->data = index;
     w->func.value_changed_callback = value_changed;
+    test_profile_widget(w, TEST_HSLIDER);
     return w;
 }
 
@@ -137,6 +237,7 @@ Widget_t* add_lv2_toggle_button(Widget_t *w, Widget_t *p, PortIndex index, const
     w->parent_struct = ui;
     w->data = index;
     w->func.value_changed_callback = value_changed;
+    test_profile_widget(w, TEST_TOGGLE_BUTTON);
     return w;
 }
 
@@ -146,6 +247,7 @@ Widget_t* add_lv2_image_toggle(Widget_t *w, Widget_t *p, PortIndex index, const
     w->parent_struct = ui;
     w->data = index;
     w->func.value_changed_callback = value_changed;
+    test_profile_widget(w, TEST_IMAGE_TOGGLE);
     return w;
 }
 
@@ -155,6 +257,7 @@ Widget_t* add_lv2_button(Widget_t *w, Widget_t *p, PortIndex index, const char *
     w->parent_struct = ui;
     w->data = index;
     w->func.value_changed_callback = value_changed;
+    test_profile_widget(w, TEST_BUTTON);
     return w;
 }
 
@@ -164,6 +267,7 @@ Widget_t* add_lv2_image_button(Widget_t *w, Widget_t *p, PortIndex index, const
     w->parent_struct = ui;
     w->data = index;
     w->func.value_changed_callback = value_changed;
+    test_profile_widget(w, TEST_IMAGE_BUTTON);
     return w;
 }
 
@@ -174,6 +278,7 @@ Widget_t* add_lv2_file_button(Widget_t *w, Widget_t *p, PortIndex index, const c
     //w->data = index;
     w->func.user_callback = dialog_response;
     //w->func.value_changed_callback = value_changed;
+    test_profile_widget(w, TEST_FILE_BUTTON);
     return w;
 }
 
@@ -183,6 +288,7 @@ Widget_t* add_lv2_valuedisplay(Widget_t *w, Widget_t *p, PortIndex index, const
     w->parent_struct = ui;
     w->data = index;
     w->func.value_changed_callback = value_changed;
+    test_profile_widget(w, TEST_VALUEDISPLAY);
     return w;
 }
 
@@ -192,6 +298,7 @@ Widget_t* add_lv2_label(Widget_t *w, Widget_t *p, PortIndex index, const char *
     w->parent_struct = ui;
     w->data = index;
     w->func.value_changed_callback = value_changed;
+    test_profile_widget(w, TEST_LABEL);
     return w;
 }
 
@@ -200,6 +307,7 @@ Widget_t* add_lv2_frame(Widget_t *w, Widget_t *p, PortIndex index, const char *
     w = add_frame(p, label, x, y, width, height);
     w->parent_struct = ui;
     w->data = index;
+    test_profile_widget(w, TEST_FRAME);
     return w;
 }
 
@@ -208,6 +316,7 @@ Widget_t* add_lv2_image(Widget_t *w, Widget_t *p, PortIndex index, const char *
     w = add_image(p, label, x, y, width, height);
     w->parent_struct = ui;
     w->data = index;
+    test_profile_widget(w, TEST_IMAGE);
     return w;
 }
 
@@ -217,6 +326,7 @@ Widget_t* add_lv2_waveview(Widget_t *w, Widget_t *p, PortIndex index, const char
     w->parent_struct = ui;
     w->data = index;
     w->func.value_changed_callback = value_changed;
+    test_profile_widget(w, TEST_WAVEVIEW);
     return w;
 }
 
@@ -225,6 +335,7 @@ Widget_t* add_lv2_tabbox(Widget_t *w, Widget_t *p, PortIndex index, const char *
     w = add_tabbox(p, label, x, y, width, height);
     w->parent_struct = ui;
     w->data = index;
+    test_profile_widget(w, TEST_TABBOX);
     return w;
 }
 
@@ -232,6 +343,7 @@ Widget_t* add_lv2_tab(Widget_t *w, Widget_t *p, PortIndex index, const char * la
     w = tabbox_add_tab(p, label);
     w->parent_struct = ui;
     w->data = index;
+    test_profile_widget(w, TEST_TAB);
     return w;
 }
 
@@ -240,6 +352,7 @@ Widget_t* add_lv2_midikeyboard(Widget_t *w, Widget_t *p, PortIndex index, const
     w = add_midi_keyboard(p, label, x, y, width, height);
     w->parent_struct = ui;
     w->data = index;
+    test_profile_widget(w, TEST_MIDIKEYBOARD);
     return w;
 }
 
@@ -270,6 +383,53 @@ void load_bg_image(X11_UI* ui, const char* image) {
     cairo_destroy(cri);
 }
 
+// sliced frames of a horizontal sprite strip, stored as user data on the widget surface
+typedef struct {
+    cairo_surface_t **frame;
+    int count;
+    bool is_slider;
+    xevfunc expose;
+    // the strip the frames were cut from
+    cairo_surface_t *image;
+    int width;
+    int height;
+} SpriteFrames;
+
+static cairo_user_data_key_t sprite_frames_key;
+
+static void sprite_frames_destroy(void *data) {
+    SpriteFrames *sprites = (SpriteFrames*)data;
+    int i = 0;
+    for (;i<sprites->count;i++) {
+        cairo_surface_destroy(sprites->frame[i]);
+    }
+    free(sprites->frame);
+    free(sprites);
+}
+
+// hand only the frame matching the adjustment state to the widget draw function
+static void draw_sprite_frame(void *w_, void* user_data) {
+    Widget_t *w = (Widget_t*)w_;
+    SpriteFrames *sprites = (SpriteFrames*)cairo_surface_get_user_data(w->surface, &sprite_frames_key);
+    // the frames went with the surface, the original expose went with them
+    if (!sprites) return;
+    int findex = (int)((sprites->count-1) * adj_get_state(w->adj));
+    cairo_surface_t *strip = w->image;
+    w->image = sprites->frame[findex];
+    if (sprites->is_slider) set_slider_image_frame_count(w, 1);
+    sprites->expose(w_, user_data);
+    if (sprites->is_slider) set_slider_image_frame_count(w, sprites->count);
+    w->image = strip;
+}
+
+// forget the frames of a replaced image and draw the widget the normal way again
+static void drop_sprite_frames(Widget_t* w) {
+    SpriteFrames *sprites = (SpriteFrames*)cairo_surface_get_user_data(w->surface, &sprite_frames_key);
+    if (!sprites) return;
+    w->func.expose_callback = sprites->expose;
+    cairo_surface_set_user_data(w->surface, &sprite_frames_key, NULL, NULL);
+}
+
 void load_controller_image(Widget_t* w, const char* image) {
     cairo_surface_t *getpng = NULL;
     if (strstr(image, ".png")) {
@@ -280,6 +440,7 @@ void load_controller_image(Widget_t* w, const char* image) {
     if (!getpng) return;
     int width = cairo_image_surface_get_width(getpng);
     int height = cairo_image_surface_get_height(getpng);
+    drop_sprite_frames(w);
     cairo_surface_destroy(w->image);
     w->image = NULL;
 
@@ -292,7 +453,230 @@ void load_controller_image(Widget_t* w, const char* image) {
     cairo_destroy(cri);
 }
 
-int main (int argc, char ** argv) {
+void slice_controller_image(Widget_t* w, int count) {
+    if (!w->image) return;
+    int width = cairo_xlib_surface_get_width(w->image);
+    int height = cairo_xlib_surface_get_height(w->image);
+    bool is_slider = count > 0;
+    if (!is_slider) count = width/max(1,height);
+    SpriteFrames *cached = (SpriteFrames*)cairo_surface_get_user_data(w->surface, &sprite_frames_key);
+    if (cached && cached->image == w->image && cached->width == width &&
+            cached->height == height && cached->count == count &&
+            cached->is_slider == is_slider) return;
+    drop_sprite_frames(w);
+    if (count < 2 || width < count) return;
+    int frame_width = width/count;
+    SpriteFrames *sprites = (SpriteFrames*)malloc(sizeof(SpriteFrames));
+    sprites->frame = (cairo_surface_t **)malloc(count * sizeof(cairo_surface_t *));
+    int i = 0;
+    for (;i<count;i++) {
+        sprites->frame[i] = cairo_surface_create_similar (w->surface, 
+                            CAIRO_CONTENT_COLOR_ALPHA, frame_width, height);
+        cairo_t *cri = cairo_create (sprites->frame[i]);
+        cairo_set_source_surface (cri, w->image, -frame_width*i, 0);
+        cairo_paint (cri);
+        cairo_destroy(cri);
+    }
+    sprites->count = count;
+    sprites->is_slider = is_slider;
+    sprites->expose = w->func.expose_callback;
+    sprites->image = w->image;
+    sprites->width = width;
+    sprites->height = height;
+    cairo_surface_set_user_data(w->surface, &sprite_frames_key, sprites, sprite_frames_destroy);
+    w->func.expose_callback = draw_sprite_frame;
+}
+
+/*---------------------------------------------------------------------
+-----------------------------------------------------------------------    
+                synthetic host port events
+-----------------------------------------------------------------------
+----------------------------------------------------------------------*/
+
+// drive the meters like a host would, --stimulus=RATE[:sine|noise[:SECONDS]]
+// or the same spec in XUI_TEST_STIMULUS
+typedef struct {
+    double rate;
+    bool noise;
+    double seconds;
+    double start;
+    double next;
+    double cpu_start;
+    long ports;
+    double *frame;
+    long frames;
+    long size;
+} TestStimulus;
+
+static TestStimulus test_stimulus;
+
+static void test_stimulus_init(int argc, char ** argv) {
+    const char *spec = getenv("XUI_TEST_STIMULUS");
+    int i = 1;
+    for (;i<argc;i++) {
+        if (strncmp(argv[i], "--stimulus=", 11) == 0) spec = argv[i] + 11;
+    }
+    if (!spec || !*spec) return;
+    char *end = NULL;
+    test_stimulus.rate = strtod(spec, &end);
+    if (test_stimulus.rate <= 0.0) {
+        fprintf(stderr, "stimulus: invalid rate in '%s'\n", spec);
+        test_stimulus.rate = 0.0;
+        return;
+    }
+    if (*end == ':') {
+        test_stimulus.noise = strncmp(end + 1, "noise", 5) == 0;
+        end = strchr(end + 1, ':');
+        if (end) test_stimulus.seconds = strtod(end + 1, NULL);
+    }
+    test_profiling = true;
+}
+
+static void null_callback(void *w_, void* user_data) {
+}
+
+// what the lv2 wrapper does with the values it collected for a frame
+static void test_port_event(X11_UI* ui, uint32_t port_index, float value) {
+    int i=0;
+    for (;i<CONTROLS;i++) {
+        if (ui->widget[i] && port_index == (uint32_t)ui->widget[i]->data) {
+            xevfunc store = ui->widget[i]->func.value_changed_callback;
+            ui->widget[i]->func.value_changed_callback = null_callback;
+            adj_set_value(ui->widget[i]->adj, value);
+            ui->widget[i]->func.value_changed_callback = store;
+        }
+    }
+    plugin_port_event(ui, port_index, sizeof(float), 0, &value);
+}
+
+// milliseconds until the next frame is due, -1 without a stimulus
+static int test_stimulus_timeout() {
+    if (test_stimulus.rate <= 0.0) return -1;
+    double wait = test_stimulus.next - test_clock(CLOCK_MONOTONIC);
+    return wait > 0.0 ? (int)(wait * 1000.0) + 1 : 0;
+}
+
+// send one value to every meter port and measure until the redraw is done,
+// returns false once the configured duration is over
+static bool test_stimulus_tick(X11_UI* ui) {
+    if (test_stimulus.rate <= 0.0) return true;
+    double now = test_clock(CLOCK_MONOTONIC);
+    if (!test_stimulus.start) {
+        test_stimulus.start = now;
+        test_stimulus.next = now;
+        test_stimulus.cpu_start = test_clock(CLOCK_PROCESS_CPUTIME_ID);
+    }
+    if (test_stimulus.seconds > 0.0 && now - test_stimulus.start >= test_stimulus.seconds) return false;
+    if (now < test_stimulus.next) return true;
+    // drop missed frames instead of catching up with a burst
+    test_stimulus.next += 1.0 / test_stimulus.rate;
+    if (test_stimulus.next < now) test_stimulus.next = now + 1.0 / test_stimulus.rate;
+
+    double t = now - test_stimulus.start;
+    int i = 0;
+    for (;i<CONTROLS;i++) {
+        Widget_t *w = ui->widget[i];
+        if (!w || !w->adj || !test_widget_is_meter(w)) continue;
+        double level = test_stimulus.noise ? (double)rand() / (double)RAND_MAX :
+                                0.5 + 0.5 * sin(2.0 * M_PI * 0.5 * t + i * 0.7);
+        test_port_event(ui, (uint32_t)w->data,
+            w->adj->min_value + (w->adj->max_value - w->adj->min_value) * level);
+        test_stimulus.ports++;
+    }
+    // the redraw requests come back as expose events, fetch and draw them
+    XSync(ui->main.dpy, False);
+    run_embedded(&ui->main);
+    XFlush(ui->main.dpy);
+
+    if (test_stimulus.frames == test_stimulus.size) {
+        test_stimulus.size = test_stimulus.size ? test_stimulus.size * 2 : 1024;
+        test_stimulus.frame = (double*)realloc(test_stimulus.frame, test_stimulus.size * sizeof(double));
+    }
+    test_stimulus.frame[test_stimulus.frames++] = (test_clock(CLOCK_MONOTONIC) - now) * 1000.0;
+    return true;
+}
+
+static Bool test_window_delete(Display *dpy, XEvent *xev, XPointer arg) {
+    X11_UI *ui = (X11_UI*)arg;
+    return xev->type == ClientMessage && xev->xclient.window == ui->win->widget &&
+        (Atom)xev->xclient.data.l[0] == XInternAtom(dpy, "WM_DELETE_WINDOW", True);
+}
+
+// a second fd to watch in the test loop, the preview runtime reads its updates here
+typedef struct {
+    int fd;
+    void (*input)(X11_UI* ui);
+} TestLoopHook;
+
+static TestLoopHook test_loop_hook = {-1, NULL};
+
+// main_run() blocks in XNextEvent, poll the X connection with the frame timeout
+// and the hook fd instead when there is a stimulus or a hook
+static void test_run(X11_UI* ui) {
+    if (test_stimulus.rate <= 0.0 && test_loop_hook.fd < 0) {
+        main_run(&ui->main);
+        return;
+    }
+    Display *dpy = ui->main.dpy;
+    Atom wm_delete_window = XInternAtom(dpy, "WM_DELETE_WINDOW", True);
+    XSetWMProtocols(dpy, ui->win->widget, &wm_delete_window, 1);
+    struct pollfd fds[2];
+    XEvent xev;
+    while (ui->main.run) {
+        fds[0].fd = ConnectionNumber(dpy);
+        fds[0].events = POLLIN;
+        fds[0].revents = 0;
+        fds[1].fd = test_loop_hook.fd;
+        fds[1].events = POLLIN;
+        fds[1].revents = 0;
+        poll(fds, test_loop_hook.fd < 0 ? 1 : 2, XPending(dpy) ? 0 : test_stimulus_timeout());
+        if (fds[1].revents) test_loop_hook.input(ui);
+        if (XCheckIfEvent(dpy, &xev, test_window_delete, (XPointer)ui)) break;
+        run_embedded(&ui->main);
+        if (!test_stimulus_tick(ui)) break;
+    }
+}
+
+static int test_compare(const void *a, const void *b) {
+    double d = *(const double*)a - *(const double*)b;
+    return (d > 0.0) - (d < 0.0);
+}
+
+static double test_percentile(double p) {
+    long i = (long)(p * (test_stimulus.frames - 1) + 0.5);
+    return test_stimulus.frame[i];
+}
+
+static void test_stimulus_report() {
+    if (test_stimulus.rate <= 0.0) return;
+    if (!test_stimulus.frames) {
+        free(test_stimulus.frame);
+        return;
+    }
+    double wall = test_clock(CLOCK_MONOTONIC) - test_stimulus.start;
+    double cpu = test_clock(CLOCK_PROCESS_CPUTIME_ID) - test_stimulus.cpu_start;
+    qsort(test_stimulus.frame, test_stimulus.frames, sizeof(double), test_compare);
+    fprintf(stderr, "\nstimulus: %.0f Hz %s, %ld frames, %ld port events in %.1f s\n",
+        test_stimulus.rate, test_stimulus.noise ? "noise" : "sine",
+        test_stimulus.frames, test_stimulus.ports, wall);
+    fprintf(stderr, "frame time ms: p50 %.3f  p90 %.3f  p99 %.3f  max %.3f\n",
+        test_percentile(0.5), test_percentile(0.9), test_percentile(0.99),
+        test_stimulus.frame[test_stimulus.frames-1]);
+    fprintf(stderr, "process cpu: %.1f%% of one core\n", 100.0 * cpu / wall);
+    fprintf(stderr, "%-14s %8s %10s %10s %10s %8s\n",
+        "widget type", "widgets", "draws", "cpu ms", "us/draw", "cpu %");
+    int i = 0;
+    for (;i<TEST_TYPES;i++) {
+        TestProfile *p = &test_profile[i];
+        if (!p->draws) continue;
+        fprintf(stderr, "%-14s %8i %10li %10.2f %10.1f %8.2f\n", p->name, p->widgets,
+            p->draws, p->cpu * 1000.0, p->cpu * 1e6 / p->draws, 100.0 * p->cpu / wall);
+    }
+    free(test_stimulus.frame);
+}
+
+// the preview runtime has its own main() and calls this one
+int test_main (int argc, char ** argv) {
 
     X11_UI* ui = (X11_UI*)malloc(sizeof(X11_UI));
     const char* plugin_uri = "TEST";
@@ -304,6 +688,7 @@ int main (int argc, char ** argv) {
 
     ui->parentXwindow = 0;
     ui->private_ptr = NULL;
+    test_stimulus_init(argc, argv);
 
     int i = 0;
     for(;i<CONTROLS;i++)
@@ -330,8 +715,9 @@ int main (int argc, char ** argv) {
     plugin_create_controller_widgets(ui,plugin_uri, 1.0);
     // map all widgets into the toplevel Widget_t
     widget_show_all(ui->win);
-    main_run(&ui->main);
-    
+    test_run(ui);
+    test_stimulus_report();
+
     free(ui->kp);
     plugin_cleanup(ui);
     // Xputty free all memory used
@@ -341,6 +727,12 @@ int main (int argc, char ** argv) {
     return 0;
 }
 
+#ifndef XUI_PREVIEW
+int main (int argc, char ** argv) {
+    return test_main(argc, argv);
+}
+#endif
+
 /*---------------------------------------------------------------------
 -----------------------------------------------------------------------    
                         LV2 interface
@@ -0,0 +1,68 @@
+/*
+ *                           0BSD 
+ * 
+ *                    BSD Zero Clause License
+ * 
+ *  Copyright (c) 2021 Hermann Meyer
+ *
+ * Permission to use, copy, modify, and/or distribute this software for any
+ * purpose with or without fee is hereby granted.
+
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES WITH
+ * REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY
+ * AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT,
+ * INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM
+ * LOSS OF USE, DATA OR PROFITS, WHETHER IN AN ACTION OF CONTRACT, NEGLIGENCE OR
+ * OTHER TORTIOUS ACTION, ARISING OUT OF OR IN CONNECTION WITH THE USE OR
+ * PERFORMANCE OF THIS SOFTWARE.
+ *
+ */
+
+
+
+#include "XUiDesigner.h"
+#include "XUiString.h"
+
+
+#pragma once
+
+#ifndef XUIATLAS_H_
+#define XUIATLAS_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// place of one png in the atlas pages
+typedef struct {
+    char *image;
+    int page;
+    int x;
+    int y;
+    int width;
+    int height;
+} AtlasEntry;
+
+typedef struct {
+    AtlasEntry *entry;
+    int entries;
+    int *page_width;
+    int *page_height;
+    int pages;
+} XUiAtlas;
+
+void atlas_init(XUiAtlas *atlas);
+
+void atlas_collect(XUiDesigner *designer, XUiAtlas *atlas);
+
+int atlas_find(XUiAtlas *atlas, const char *image);
+
+int atlas_compose(XUiAtlas *atlas, int page, const char *name, XUiString *out);
+
+void atlas_free(XUiAtlas *atlas);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif //XUIATLAS_H_
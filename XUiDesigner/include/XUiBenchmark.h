@@ -0,0 +1,44 @@
+/*
+ *                           0BSD 
+ * 
+ *                    BSD Zero Clause License
+ * 
+ *  Copyright (c) 2021 Hermann Meyer
+ *
+ * Permission to use, copy, modify, and/or distribute this software for any
+ * purpose with or without fee is hereby granted.
+
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES WITH
+ * REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY
+ * AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT,
+ * INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM
+ * LOSS OF USE, DATA OR PROFITS, WHETHER IN AN ACTION OF CONTRACT, NEGLIGENCE OR
+ * OTHER TORTIOUS ACTION, ARISING OUT OF OR IN CONNECTION WITH THE USE OR
+ * PERFORMANCE OF THIS SOFTWARE.
+ *
+ */
+
+
+
+#include "XUiDesigner.h"
+
+
+#pragma once
+
+#ifndef XUIBENCHMARK_H_
+#define XUIBENCHMARK_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+void run_save_benchmark(XUiDesigner *designer, int controls, int images);
+
+// returns non zero when two saves of the same project write different json
+int run_save_check(XUiDesigner *designer);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif //XUIBENCHMARK_H_
@@ -116,6 +116,18 @@ typedef enum {
     IS_IMAGE_BUTTON   ,
 } WidgetType;
 
+/*---------------------------------------------------------------------
+-----------------------------------------------------------------------    
+                struct to hold the sliced frames of a sprite strip
+-----------------------------------------------------------------------
+----------------------------------------------------------------------*/
+
+typedef struct {
+    cairo_surface_t **frame;
+    int count;
+    xevfunc expose;
+} ControllerSprites;
+
 /*---------------------------------------------------------------------
 -----------------------------------------------------------------------    
                 struct to hold the info for printout
@@ -135,6 +147,7 @@ typedef struct {
     int in_tab;
     int tab_box;
     int slider_image_sprites;
+    ControllerSprites sprites;
     bool destignation_enabled;
     bool is_atom_patch;
     bool is_midi_patch;
@@ -145,6 +158,14 @@ typedef struct {
     bool have_adjustment;
 } Controller;
 
+typedef struct XUiScheduler XUiScheduler;
+
+typedef struct XUiExecutor XUiExecutor;
+
+typedef struct XUiJob XUiJob;
+
+typedef struct XUiLivePreview XUiLivePreview;
+
 /*---------------------------------------------------------------------
 -----------------------------------------------------------------------    
                 struct to hold the info for the designer
@@ -194,6 +215,20 @@ typedef struct {
     char pad[3];
 } DragIcon;
 
+// how a saved bundle gets libxputty
+typedef enum {
+    REPO_SUBMODULE,
+    REPO_MIRROR,
+    REPO_VENDOR,
+    REPO_SKIP,
+} RepoSetup;
+
+// a project image and the first one with the same content
+typedef struct {
+    char *image;
+    int same;
+} SharedImage;
+
 typedef struct {
     LilvWorld* world;
     const LilvPlugins* lv2_plugins;        
@@ -205,6 +240,9 @@ typedef struct {
     Widget_t *aspect_ratio;
     Widget_t *resize_all;
     Widget_t *move_all;
+    Widget_t *startup_images;
+    Widget_t *lazy_tabs;
+    Widget_t *layout_table;
     Widget_t *active_widget;
     Widget_t *prev_active_widget;
     Widget_t *w;
@@ -263,6 +301,7 @@ typedef struct {
     Widget_t *ctype_switch;
     Widget_t *test;
     Widget_t *save;
+    Widget_t *save_status;
     Widget_t *exit;
     Cursor cursor;
     Colors *selected_scheme;
@@ -279,6 +318,7 @@ typedef struct {
     bool run;
     bool skipit;
     bool pad;
+    bool ttlfile_view_mapped;
     int global_vslider_image_sprites;
     int global_hslider_image_sprites;
     int multi_selected;
@@ -318,6 +358,16 @@ typedef struct {
     char* path;
     char* json_file_path;
     LV2_CONTROLLER lv2c;
+    XUiScheduler *scheduler;
+    XUiExecutor *executor;
+    XUiJob *world_job;
+    XUiJob *save_job;
+    XUiJob *test_job;
+    XUiLivePreview *live_preview;
+    SharedImage *shared_image;
+    int shared_images;
+    RepoSetup repo_setup;
+    char *libxputty_path;
     Controller controls[MAX_CONTROLS];
 } XUiDesigner;
 
@@ -337,12 +387,16 @@ void move_tab(void *w_, void *xmotion_, void* user_data);
 
 void hide_show_as_needed(XUiDesigner *designer);
 
-void *reset_flag(void *designer_);
+void reset_fast_redraw(XUiDesigner *designer);
+
+void designer_changed(XUiDesigner *designer);
 
 char *getUserName(void);
 
 void load_lv2_uris (XUiDesigner *designer);
 
+void load_lv2_uris_async(XUiDesigner *designer);
+
 void load_lv2_ui(void *w_, void* user_data);
 
 Widget_t *get_active_widget(XUiDesigner *designer);
@@ -0,0 +1,50 @@
+/*
+ *                           0BSD 
+ * 
+ *                    BSD Zero Clause License
+ * 
+ *  Copyright (c) 2021 Hermann Meyer
+ *
+ * Permission to use, copy, modify, and/or distribute this software for any
+ * purpose with or without fee is hereby granted.
+
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES WITH
+ * REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY
+ * AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT,
+ * INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM
+ * LOSS OF USE, DATA OR PROFITS, WHETHER IN AN ACTION OF CONTRACT, NEGLIGENCE OR
+ * OTHER TORTIOUS ACTION, ARISING OUT OF OR IN CONNECTION WITH THE USE OR
+ * PERFORMANCE OF THIS SOFTWARE.
+ *
+ */
+
+
+
+#include "XUiDesigner.h"
+#include "XUiString.h"
+
+
+#pragma once
+
+#ifndef XUIEMBED_H_
+#define XUIEMBED_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+int embed_read_file(const char *filename, unsigned char **data, size_t *size);
+
+void embed_hex_bytes(XUiString *out, const unsigned char *data, size_t size, int per_line, bool more);
+
+void embed_hex_words(XUiString *out, const uint32_t *data, size_t count, int per_line, bool more);
+
+void embed_c_array(XUiString *out, const char *name, const unsigned char *data, size_t size);
+
+void embed_base64_string(XUiString *out, const char *name, const unsigned char *data, size_t size);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif //XUIEMBED_H_
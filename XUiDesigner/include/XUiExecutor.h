@@ -0,0 +1,69 @@
+/*
+ *                           0BSD 
+ * 
+ *                    BSD Zero Clause License
+ * 
+ *  Copyright (c) 2021 Hermann Meyer
+ *
+ * Permission to use, copy, modify, and/or distribute this software for any
+ * purpose with or without fee is hereby granted.
+
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES WITH
+ * REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY
+ * AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT,
+ * INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM
+ * LOSS OF USE, DATA OR PROFITS, WHETHER IN AN ACTION OF CONTRACT, NEGLIGENCE OR
+ * OTHER TORTIOUS ACTION, ARISING OUT OF OR IN CONNECTION WITH THE USE OR
+ * PERFORMANCE OF THIS SOFTWARE.
+ *
+ */
+
+
+
+#include "XUiDesigner.h"
+#include "XUiScheduler.h"
+
+
+#pragma once
+
+#ifndef XUIEXECUTOR_H_
+#define XUIEXECUTOR_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// runs on a worker thread, should check job_is_cancelled() now and then
+typedef void (*job_func)(XUiJob *job, void *data);
+
+// runs on the UI thread once the job is finished or cancelled, the job is freed afterwards
+typedef void (*job_done_func)(XUiJob *job, void *data);
+
+// runs on the UI thread for each job_progress() call of the worker
+typedef void (*job_progress_func)(XUiJob *job, void *data, int step, int steps, const char *msg);
+
+// runs once for each item handed to executor_parallel()
+typedef void (*parallel_func)(void *item);
+
+XUiExecutor *executor_new(XUiScheduler *sched, int threads);
+
+void executor_free(XUiExecutor *ex);
+
+XUiJob *executor_submit(XUiExecutor *ex, job_func run, job_done_func done,
+                                    job_progress_func progress, void *data);
+
+void executor_wait(XUiExecutor *ex, XUiJob *job);
+
+void executor_parallel(XUiExecutor *ex, parallel_func run, void **items, int count);
+
+void job_cancel(XUiJob *job);
+
+bool job_is_cancelled(XUiJob *job);
+
+void job_progress(XUiJob *job, int step, int steps, const char *msg);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif //XUIEXECUTOR_H_
@@ -21,6 +21,7 @@
 
 
 #include "XUiDesigner.h"
+#include "XUiString.h"
 
 
 #pragma once
@@ -32,6 +33,8 @@
 extern "C" {
 #endif
 
+typedef void (*generate_func)(XUiDesigner *designer, XUiString *out);
+
 void strovar(char* c);
 
 void strtovar(char* c);
@@ -45,7 +48,15 @@ void remove_from_list(XUiDesigner *designer, Widget_t *wid);
 void add_to_list(XUiDesigner *designer, Widget_t *wid, const char* type,
                                     bool have_adjustment, WidgetType is_type);
 
-void print_makefile(XUiDesigner *designer);
+void print_makefile(XUiDesigner *designer, XUiString *out);
+
+char *generate_text(XUiDesigner *designer, generate_func generate, size_t *size);
+
+void collect_shared_images(XUiDesigner *designer);
+
+const char *shared_image(XUiDesigner *designer, const char *image);
+
+void free_shared_images(XUiDesigner *designer);
 
 void show_list(XUiDesigner *designer);
 
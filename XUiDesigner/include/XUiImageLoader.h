@@ -45,6 +45,12 @@ void pop_menu_response(void *w_, void* item_, void* user_data);
 
 void load_single_controller_image (XUiDesigner *designer, const char* filename);
 
+void sprite_frames_slice(XUiDesigner *designer, Widget_t *wid);
+
+void sprite_frames_free(XUiDesigner *designer, Widget_t *wid);
+
+void sprite_frames_free_all(XUiDesigner *designer);
+
 #ifdef __cplusplus
 }
 #endif
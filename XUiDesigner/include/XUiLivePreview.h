@@ -0,0 +1,48 @@
+/*
+ *                           0BSD 
+ * 
+ *                    BSD Zero Clause License
+ * 
+ *  Copyright (c) 2021 Hermann Meyer
+ *
+ * Permission to use, copy, modify, and/or distribute this software for any
+ * purpose with or without fee is hereby granted.
+
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES WITH
+ * REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY
+ * AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT,
+ * INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM
+ * LOSS OF USE, DATA OR PROFITS, WHETHER IN AN ACTION OF CONTRACT, NEGLIGENCE OR
+ * OTHER TORTIOUS ACTION, ARISING OUT OF OR IN CONNECTION WITH THE USE OR
+ * PERFORMANCE OF THIS SOFTWARE.
+ *
+ */
+
+
+
+#include "XUiDesigner.h"
+
+
+#pragma once
+
+#ifndef XUILIVEPREVIEW_H_
+#define XUILIVEPREVIEW_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+XUiLivePreview *live_preview_start(XUiDesigner *designer, const char *runtime);
+
+void live_preview_sync(XUiLivePreview *lp);
+
+// the designer changed, sync the preview once the edits settle
+void live_preview_changed(XUiLivePreview *lp);
+
+void live_preview_free(XUiLivePreview *lp);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif //XUILIVEPREVIEW_H_
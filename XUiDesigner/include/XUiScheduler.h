@@ -0,0 +1,59 @@
+/*
+ *                           0BSD 
+ * 
+ *                    BSD Zero Clause License
+ * 
+ *  Copyright (c) 2021 Hermann Meyer
+ *
+ * Permission to use, copy, modify, and/or distribute this software for any
+ * purpose with or without fee is hereby granted.
+
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES WITH
+ * REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY
+ * AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT,
+ * INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM
+ * LOSS OF USE, DATA OR PROFITS, WHETHER IN AN ACTION OF CONTRACT, NEGLIGENCE OR
+ * OTHER TORTIOUS ACTION, ARISING OUT OF OR IN CONNECTION WITH THE USE OR
+ * PERFORMANCE OF THIS SOFTWARE.
+ *
+ */
+
+
+
+#include "XUiDesigner.h"
+
+
+#pragma once
+
+#ifndef XUISCHEDULER_H_
+#define XUISCHEDULER_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef void (*scheduler_func)(void *data);
+
+typedef void (*scheduler_fd_func)(int fd, void *data);
+
+XUiScheduler *scheduler_new(Xputty *app, Window main_window);
+
+void scheduler_free(XUiScheduler *sched);
+
+void scheduler_run(XUiScheduler *sched);
+
+void scheduler_timeout(XUiScheduler *sched, int msec, scheduler_func func, void *data);
+
+void scheduler_cancel(XUiScheduler *sched, scheduler_func func, void *data);
+
+void scheduler_queue_redraw(XUiScheduler *sched, Widget_t *w);
+
+void scheduler_watch_fd(XUiScheduler *sched, int fd, scheduler_fd_func func, void *data);
+
+void scheduler_unwatch_fd(XUiScheduler *sched, int fd);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif //XUISCHEDULER_H_
@@ -0,0 +1,64 @@
+/*
+ *                           0BSD 
+ * 
+ *                    BSD Zero Clause License
+ * 
+ *  Copyright (c) 2021 Hermann Meyer
+ *
+ * Permission to use, copy, modify, and/or distribute this software for any
+ * purpose with or without fee is hereby granted.
+
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES WITH
+ * REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY
+ * AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT,
+ * INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM
+ * LOSS OF USE, DATA OR PROFITS, WHETHER IN AN ACTION OF CONTRACT, NEGLIGENCE OR
+ * OTHER TORTIOUS ACTION, ARISING OUT OF OR IN CONNECTION WITH THE USE OR
+ * PERFORMANCE OF THIS SOFTWARE.
+ *
+ */
+
+
+
+#include "XUiDesigner.h"
+
+
+#pragma once
+
+#ifndef XUISTRING_H_
+#define XUISTRING_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// growable text buffer the generators write to
+typedef struct {
+    char *str;
+    size_t len;
+    size_t size;
+} XUiString;
+
+void xstring_init(XUiString *s);
+
+void xstring_free(XUiString *s);
+
+void xstring_reset(XUiString *s);
+
+void xstring_append(XUiString *s, const char *str);
+
+void xstring_append_len(XUiString *s, const char *str, size_t len);
+
+void xstring_printf(XUiString *s, const char *fmt, ...) __attribute__((format(printf, 2, 3)));
+
+char *xstring_steal(XUiString *s, size_t *len);
+
+int xstring_write_file(XUiString *s, const char *filename);
+
+uint64_t hash_data(const void *data, size_t len);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif //XUISTRING_H_
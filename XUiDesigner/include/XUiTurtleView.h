@@ -32,10 +32,14 @@
 extern "C" {
 #endif
 
+#define PREVIEW_TABS 4
+
 void create_text_view_window(XUiDesigner *designer);
 
 void run_generate_ttl(void *w_, void* user_data);
 
+void preview_notify_changed(XUiDesigner *designer);
+
 #ifdef __cplusplus
 }
 #endif
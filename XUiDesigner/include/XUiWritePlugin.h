@@ -21,6 +21,7 @@
 
 
 #include "XUiDesigner.h"
+#include "XUiString.h"
 
 
 #pragma once
@@ -32,7 +33,7 @@
 extern "C" {
 #endif
 
-void print_plugin(XUiDesigner *designer);
+void print_plugin(XUiDesigner *designer, XUiString *out);
 
 #ifdef __cplusplus
 }
@@ -21,6 +21,7 @@
 
 
 #include "XUiDesigner.h"
+#include "XUiString.h"
 
 
 #pragma once
@@ -32,9 +33,9 @@
 extern "C" {
 #endif
 
-void print_ttl(XUiDesigner *designer);
+void print_ttl(XUiDesigner *designer, XUiString *out);
 
-void print_manifest(XUiDesigner *designer);
+void print_manifest(XUiDesigner *designer, XUiString *out);
 
 #ifdef __cplusplus
 }
@@ -21,6 +21,7 @@
 
 
 #include "XUiDesigner.h"
+#include "XUiString.h"
 
 
 #pragma once
@@ -32,11 +33,22 @@
 extern "C" {
 #endif
 
+// X11_UI array sizes for test builds, the cached ui_test.cc object uses the same
+#define TEST_CONTROLS MAX_CONTROLS
+#define TEST_GUI_ELEMENTS MAX_CONTROLS
+#define TEST_TAB_ELEMENTS 1024
+
+int png2c_source(const char* image_name, const char* name, XUiString *out);
+
+int png2c_surface(cairo_surface_t *image, const char* name, XUiString *out);
+
 void png2c(char* image_name, char* filepath);
 
 const char* parse_adjusment_type(CL_type cl_type);
 
-void print_list(XUiDesigner *designer);
+void print_list(XUiDesigner *designer, XUiString *out);
+
+void print_preview(XUiDesigner *designer, XUiString *out);
 
 #ifdef __cplusplus
 }
@@ -0,0 +1,497 @@
+/*
+ *                           0BSD 
+ * 
+ *                    BSD Zero Clause License
+ * 
+ *  Copyright (c) 2021 Hermann Meyer
+ *
+ * Permission to use, copy, modify, and/or distribute this software for any
+ * purpose with or without fee is hereby granted.
+
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES WITH
+ * REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY
+ * AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT,
+ * INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM
+ * LOSS OF USE, DATA OR PROFITS, WHETHER IN AN ACTION OF CONTRACT, NEGLIGENCE OR
+ * OTHER TORTIOUS ACTION, ARISING OUT OF OR IN CONNECTION WITH THE USE OR
+ * PERFORMANCE OF THIS SOFTWARE.
+ *
+ */
+
+
+/*
+ * xuipreview replays the widget description XUiDesigner writes for test mode
+ * (see print_preview()) on top of the ui_test.cc wrapper, so a test run
+ * doesn't need to compile the generated UI first.
+ * Started with --live it keeps reading changed lines on stdin and applies
+ * them to the running UI.
+ * --stimulus or XUI_TEST_STIMULUS feed the meters like ui_test.cc does.
+ */
+
+#define CONTROLS 225
+#define GUI_ELEMENTS 225
+#define TAB_ELEMENTS 1024
+#define PLUGIN_UI_URI "urn:xuidesigner:preview"
+#define XUI_PREVIEW
+
+#include <poll.h>
+#include <errno.h>
+#include <unistd.h>
+#include "lv2_plugin.h"
+
+// with XUI_PREVIEW ui_test.cc leaves main() to this file, test_main() runs
+// the UI and the live mode watches stdin through test_loop_hook
+#include "ui_test.cc"
+
+
+typedef Widget_t* (*add_lv2_func)(Widget_t *w, Widget_t *p, PortIndex index, const char * label,
+                                X11_UI* ui, int x, int y, int width, int height);
+
+typedef struct {
+    const char *name;
+    add_lv2_func add;
+} PreviewType;
+
+static const PreviewType preview_types[] = {
+    {"add_lv2_knob", add_lv2_knob},
+    {"add_lv2_combobox", add_lv2_combobox},
+    {"add_lv2_vmeter", add_lv2_vmeter},
+    {"add_lv2_hmeter", add_lv2_hmeter},
+    {"add_lv2_vslider", add_lv2_vslider},
+    {"add_lv2_hslider", add_lv2_hslider},
+    {"add_lv2_toggle_button", add_lv2_toggle_button},
+    {"add_lv2_image_toggle", add_lv2_image_toggle},
+    {"add_lv2_button", add_lv2_button},
+    {"add_lv2_image_button", add_lv2_image_button},
+    {"add_lv2_file_button", add_lv2_file_button},
+    {"add_lv2_valuedisplay", add_lv2_valuedisplay},
+    {"add_lv2_label", add_lv2_label},
+    {"add_lv2_frame", add_lv2_frame},
+    {"add_lv2_image", add_lv2_image},
+    {"add_lv2_waveview", add_lv2_waveview},
+    {"add_lv2_tabbox", add_lv2_tabbox},
+    {"add_lv2_midikeyboard", add_lv2_midikeyboard},
+};
+
+// an update line stays around while a widget label points into it
+typedef struct {
+    Widget_t *w;
+    char *line;
+} PreviewHeld;
+
+// the description stays loaded, widget labels point into it and into the held lines
+typedef struct {
+    char *text;
+    char **line;
+    int lines;
+    int width;
+    int height;
+    const char *name;
+    float scale;
+    bool live;
+    X11_UI *ui;
+    char *input;
+    size_t input_len;
+    char *reload;
+    size_t reload_len;
+    bool reloading;
+    PreviewHeld *held;
+    int helds;
+} Preview;
+
+static Preview preview = {NULL, NULL, 0, 1, 1, "Test", 1.0, false, NULL,
+                                    NULL, 0, NULL, 0, false, NULL, 0};
+
+/*---------------------------------------------------------------------
+-----------------------------------------------------------------------    
+                read the widget description
+-----------------------------------------------------------------------
+----------------------------------------------------------------------*/
+
+// split a line in place into tab separated fields
+static int preview_fields(char *line, char **field, int max) {
+    int n = 0;
+    while (line && n < max) {
+        field[n++] = strsep(&line, "\t");
+    }
+    return n;
+}
+
+static void preview_free() {
+    free(preview.line);
+    free(preview.text);
+    preview.line = NULL;
+    preview.text = NULL;
+    preview.lines = 0;
+    int i = 0;
+    for (;i<preview.helds;i++) {
+        free(preview.held[i].line);
+    }
+    free(preview.held);
+    preview.held = NULL;
+    preview.helds = 0;
+}
+
+// takes over the text
+static int preview_parse(char *text) {
+    preview.text = text;
+    int count = 1;
+    char *c = preview.text;
+    for (;*c;c++) {
+        if (*c == '\n') count++;
+    }
+    preview.line = (char**)malloc(count * sizeof(char*));
+    char *next = preview.text;
+    while (next) {
+        char *l = strsep(&next, "\n");
+        if (*l) preview.line[preview.lines++] = l;
+    }
+    if (!preview.lines || strcmp(preview.line[0], "xuipreview\t1") != 0) {
+        preview_free();
+        return -1;
+    }
+    int i = 1;
+    for (;i<preview.lines;i++) {
+        if (strncmp(preview.line[i], "window\t", 7) == 0) {
+            char *f[4];
+            if (preview_fields(preview.line[i], f, 4) == 4) {
+                preview.width = max(1, atoi(f[1]));
+                preview.height = max(1, atoi(f[2]));
+                preview.name = f[3];
+            }
+            preview.line[i] = NULL;
+            break;
+        }
+    }
+    return 0;
+}
+
+static int preview_load(const char *path) {
+    FILE *fp = fopen(path, "rb");
+    if (!fp) return -1;
+    fseek(fp, 0, SEEK_END);
+    long size = ftell(fp);
+    fseek(fp, 0, SEEK_SET);
+    if (size <= 0) {
+        fclose(fp);
+        return -1;
+    }
+    char *text = (char*)malloc(size + 1);
+    size_t r = fread(text, 1, size, fp);
+    fclose(fp);
+    text[r] = '\0';
+    return preview_parse(text);
+}
+
+/*---------------------------------------------------------------------
+-----------------------------------------------------------------------    
+                replay the description on the UI
+-----------------------------------------------------------------------
+----------------------------------------------------------------------*/
+
+static add_lv2_func preview_type(const char *name) {
+    unsigned int i = 0;
+    for (;i<sizeof(preview_types)/sizeof(preview_types[0]);i++) {
+        if (strcmp(preview_types[i].name, name) == 0) return preview_types[i].add;
+    }
+    return NULL;
+}
+
+// "win", "wN" for ui->widget, "eN" for ui->elem and "tN" for ui->tab_elem
+static Widget_t *preview_widget(X11_UI *ui, const char *ref) {
+    int i = atoi(ref+1);
+    switch (ref[0]) {
+        case 'w':
+            if (strcmp(ref, "win") == 0) return ui->win;
+            return (i >= 0 && i < CONTROLS) ? ui->widget[i] : NULL;
+        break;
+        case 'e':
+            return (i >= 0 && i < GUI_ELEMENTS) ? ui->elem[i] : NULL;
+        break;
+        case 't':
+            return (i >= 0 && i < TAB_ELEMENTS) ? ui->tab_elem[i] : NULL;
+        break;
+        default:
+        break;
+    }
+    return NULL;
+}
+
+static void preview_theme(X11_UI *ui, char **f) {
+    Colors *c = get_color_scheme(ui->win, (Color_state)atoi(f[1]));
+    double *mod[7] = {c->fg, c->bg, c->base, c->text, c->shadow, c->frame, c->light};
+    int i = 0;
+    for (;i<28;i++) {
+        mod[i/4][i%4] = atof(f[i+2]);
+    }
+}
+
+// a new image replaces the sprite frames sliced from the old one
+static void preview_unslice(Widget_t *w) {
+    SpriteFrames *sprites = (SpriteFrames*)cairo_surface_get_user_data(w->surface, &sprite_frames_key);
+    if (!sprites) return;
+    w->func.expose_callback = sprites->expose;
+    cairo_surface_set_user_data(w->surface, &sprite_frames_key, NULL, NULL);
+}
+
+static void preview_line(X11_UI *ui, char *line, float scale) {
+    char *f[30];
+    int n = preview_fields(line, f, 30);
+    Widget_t *w = n > 1 ? preview_widget(ui, f[1]) : NULL;
+    if (strcmp(f[0], "theme") == 0 && n == 30) {
+        preview_theme(ui, f);
+    } else if (strcmp(f[0], "background") == 0 && n == 2) {
+        load_bg_image(ui, f[1]);
+    } else if (strcmp(f[0], "elem") == 0 && n == 9) {
+        int i = atoi(f[1]);
+        add_lv2_func add = preview_type(f[2]);
+        if (!add || i < 0 || i >= GUI_ELEMENTS) return;
+        ui->elem[i] = add(ui->elem[i], ui->win, atoi(f[3]), f[8], ui,
+                atoi(f[4]), atoi(f[5]), atoi(f[6]) * scale, atoi(f[7]) * scale);
+    } else if (strcmp(f[0], "tab") == 0 && n == 4) {
+        int i = atoi(f[1]);
+        int e = atoi(f[2]);
+        if (i < 0 || i >= TAB_ELEMENTS || e < 0 || e >= GUI_ELEMENTS || !ui->elem[e]) return;
+        ui->tab_elem[i] = add_lv2_tab(ui->tab_elem[i], ui->elem[e], -1, f[3], ui);
+    } else if (strcmp(f[0], "widget") == 0 && n == 10) {
+        int i = atoi(f[1]);
+        add_lv2_func add = preview_type(f[2]);
+        Widget_t *p = preview_widget(ui, f[3]);
+        if (!add || !p || i < 0 || i >= CONTROLS) return;
+        ui->widget[i] = add(ui->widget[i], p, atoi(f[4]), f[9], ui,
+                atoi(f[5]), atoi(f[6]), atoi(f[7]) * scale, atoi(f[8]) * scale);
+    } else if (!w) {
+        return;
+    } else if (strcmp(f[0], "image") == 0 && n == 3) {
+        preview_unslice(w);
+        load_controller_image(w, f[2]);
+    } else if (strcmp(f[0], "frames") == 0 && n == 3) {
+        set_slider_image_frame_count(w, atoi(f[2]));
+    } else if (strcmp(f[0], "slice") == 0 && n == 3) {
+        slice_controller_image(w, atoi(f[2]));
+    } else if (strcmp(f[0], "entry") == 0 && n == 3) {
+        combobox_add_entry(w, f[2]);
+    } else if (strcmp(f[0], "adjustment") == 0 && n == 7 && w->adj) {
+        set_adjustment(w->adj, atof(f[2]), atof(f[2]), atof(f[3]), atof(f[4]),
+                                                atof(f[5]), (CL_type)atoi(f[6]));
+    } else if (strcmp(f[0], "color") == 0 && n == 8) {
+        set_widget_color(w, (Color_state)atoi(f[2]), (Color_mod)atoi(f[3]),
+                            atof(f[4]), atof(f[5]), atof(f[6]), atof(f[7]));
+    }
+}
+
+/*---------------------------------------------------------------------
+-----------------------------------------------------------------------    
+                apply the changes send by the designer
+-----------------------------------------------------------------------
+----------------------------------------------------------------------*/
+
+static void preview_place(Widget_t *w, char **f, const char *label, float scale) {
+    int x = atoi(f[0]);
+    int y = atoi(f[1]);
+    int width = max(1, atoi(f[2]) * scale);
+    int height = max(1, atoi(f[3]) * scale);
+    w->label = label;
+    w->scale.init_x = x;
+    w->scale.init_y = y;
+    w->scale.init_width = width;
+    w->scale.init_height = height;
+    XMoveResizeWindow(w->app->dpy, w->widget, x, y, width, height);
+}
+
+// the designer sends a line again when a value of an existing widget changed,
+// returns the widget whose label points into the line from now on
+static Widget_t *preview_update(X11_UI *ui, char *line, float scale) {
+    char *f[10];
+    if (strncmp(line, "window\t", 7) == 0) {
+        if (preview_fields(line, f, 4) != 4) return NULL;
+        preview.width = max(1, atoi(f[1]));
+        preview.height = max(1, atoi(f[2]));
+        ui->win->label = f[3];
+        ui->win->scale.init_width = preview.width * scale;
+        ui->win->scale.init_height = preview.height * scale;
+        widget_set_title(ui->win, f[3]);
+        XResizeWindow(ui->main.dpy, ui->win->widget, preview.width * scale, preview.height * scale);
+        return ui->win;
+    } else if (strncmp(line, "widget\t", 7) == 0) {
+        if (preview_fields(line, f, 10) != 10) return NULL;
+        int i = atoi(f[1]);
+        if (i < 0 || i >= CONTROLS || !ui->widget[i]) return NULL;
+        preview_place(ui->widget[i], &f[5], f[9], scale);
+        return ui->widget[i];
+    } else if (strncmp(line, "elem\t", 5) == 0) {
+        if (preview_fields(line, f, 9) != 9) return NULL;
+        int i = atoi(f[1]);
+        if (i < 0 || i >= GUI_ELEMENTS || !ui->elem[i]) return NULL;
+        preview_place(ui->elem[i], &f[4], f[8], scale);
+        return ui->elem[i];
+    } else if (strncmp(line, "tab\t", 4) == 0) {
+        if (preview_fields(line, f, 4) != 4) return NULL;
+        int i = atoi(f[1]);
+        if (i < 0 || i >= TAB_ELEMENTS || !ui->tab_elem[i]) return NULL;
+        ui->tab_elem[i]->label = f[3];
+        return ui->tab_elem[i];
+    }
+    preview_line(ui, line, scale);
+    return NULL;
+}
+
+static void preview_redraw(X11_UI *ui) {
+    expose_widget(ui->win);
+    int i = 0;
+    for (;i<GUI_ELEMENTS;i++) {
+        if (ui->elem[i]) expose_widget(ui->elem[i]);
+    }
+    for (i=0;i<TAB_ELEMENTS;i++) {
+        if (ui->tab_elem[i]) expose_widget(ui->tab_elem[i]);
+    }
+    for (i=0;i<CONTROLS;i++) {
+        if (ui->widget[i]) expose_widget(ui->widget[i]);
+    }
+}
+
+// the widget tree changed, build the UI again from the new description
+static void preview_rebuild(X11_UI *ui) {
+    int i = 0;
+    for (;i<CONTROLS;i++) {
+        if (ui->widget[i]) destroy_widget(ui->widget[i], &ui->main);
+        ui->widget[i] = NULL;
+    }
+    for (i=0;i<GUI_ELEMENTS;i++) {
+        if (ui->elem[i]) destroy_widget(ui->elem[i], &ui->main);
+        ui->elem[i] = NULL;
+    }
+    cairo_surface_destroy(ui->win->image);
+    ui->win->image = NULL;
+    preview_free();
+    char *text = preview.reload;
+    preview.reload = NULL;
+    preview.reload_len = 0;
+    if (preview_parse(text)) return;
+    ui->win->label = preview.name;
+    ui->win->scale.init_width = preview.width * preview.scale;
+    ui->win->scale.init_height = preview.height * preview.scale;
+    widget_set_title(ui->win, preview.name);
+    XResizeWindow(ui->main.dpy, ui->win->widget, preview.width * preview.scale,
+                                                preview.height * preview.scale);
+    plugin_create_controller_widgets(ui, PLUGIN_UI_URI, preview.scale);
+    widget_show_all(ui->win);
+}
+
+static void preview_append(char **buf, size_t *len, const char *data, size_t size) {
+    *buf = (char*)realloc(*buf, *len + size + 1);
+    memcpy(*buf + *len, data, size);
+    *len += size;
+    (*buf)[*len] = '\0';
+}
+
+// only the last line for a widget is in use, it replaces the one held before
+static void preview_hold(Widget_t *w, char *line) {
+    int i = 0;
+    for (;i<preview.helds;i++) {
+        if (preview.held[i].w == w) {
+            free(preview.held[i].line);
+            preview.held[i].line = line;
+            return;
+        }
+    }
+    preview.held = (PreviewHeld*)realloc(preview.held, (preview.helds+1) * sizeof(PreviewHeld));
+    preview.held[preview.helds].w = w;
+    preview.held[preview.helds++].line = line;
+}
+
+// "reload" ... "end" brings a full description, all other lines are updates
+static void preview_input(X11_UI *ui) {
+    char buf[4096];
+    ssize_t r = read(STDIN_FILENO, buf, sizeof(buf));
+    if (r < 0 && (errno == EINTR || errno == EAGAIN)) return;
+    if (r <= 0) {
+        // the designer is gone
+        ui->main.run = false;
+        return;
+    }
+    preview_append(&preview.input, &preview.input_len, buf, r);
+    char *start = preview.input;
+    char *end = NULL;
+    while ((end = strchr(start, '\n'))) {
+        *end = '\0';
+        if (preview.reloading && strcmp(start, "end") == 0) {
+            preview.reloading = false;
+            preview_rebuild(ui);
+        } else if (preview.reloading) {
+            preview_append(&preview.reload, &preview.reload_len, start, end - start);
+            preview_append(&preview.reload, &preview.reload_len, "\n", 1);
+        } else if (strcmp(start, "reload") == 0) {
+            preview.reloading = true;
+        } else if (*start) {
+            char *line = strdup(start);
+            Widget_t *w = preview_update(ui, line, preview.scale);
+            if (w) preview_hold(w, line);
+            else free(line);
+        }
+        start = end + 1;
+    }
+    preview.input_len -= start - preview.input;
+    memmove(preview.input, start, preview.input_len + 1);
+    if (!preview.reloading) preview_redraw(ui);
+}
+
+/*---------------------------------------------------------------------
+-----------------------------------------------------------------------    
+                the plugin interface used by ui_test.cc
+-----------------------------------------------------------------------
+----------------------------------------------------------------------*/
+
+void plugin_value_changed(X11_UI *ui, Widget_t *w, PortIndex index) {
+}
+
+void plugin_set_window_size(int *w,int *h,const char * plugin_uri, float scale) {
+    (*w) = preview.width * scale;
+    (*h) = preview.height * scale;
+}
+
+const char* plugin_set_name() {
+    return preview.name;
+}
+
+void plugin_create_controller_widgets(X11_UI *ui, const char * plugin_uri, float scale) {
+    preview.ui = ui;
+    preview.scale = scale;
+    int i = 0;
+    for (;i<TAB_ELEMENTS;i++) {
+        ui->tab_elem[i] = NULL;
+    }
+    for (i=1;i<preview.lines;i++) {
+        if (preview.line[i]) preview_line(ui, preview.line[i], scale);
+    }
+}
+
+void plugin_cleanup(X11_UI *ui) {
+}
+
+void plugin_port_event(LV2UI_Handle handle, uint32_t port_index,
+                        uint32_t buffer_size, uint32_t format,
+                        const void * buffer) {
+}
+
+int main (int argc, char ** argv) {
+    const char *path = NULL;
+    int i = 1;
+    for (;i<argc;i++) {
+        if (strcmp(argv[i], "--live") == 0) preview.live = true;
+        else if (strncmp(argv[i], "--", 2) != 0) path = argv[i];
+    }
+    if (!path || preview_load(path)) {
+        fprintf(stderr, "usage: xuipreview [--live] [--stimulus=RATE[:sine|noise[:SECONDS]]] DESCRIPTION\n");
+        return 1;
+    }
+    if (preview.live) {
+        test_loop_hook.fd = STDIN_FILENO;
+        test_loop_hook.input = preview_input;
+    }
+    int ret = test_main(argc, argv);
+    preview_free();
+    free(preview.input);
+    free(preview.reload);
+    return ret;
+}
@@ -0,0 +1,191 @@
+/*
+ *                           0BSD 
+ * 
+ *                    BSD Zero Clause License
+ * 
+ *  Copyright (c) 2021 Hermann Meyer
+ *
+ * Permission to use, copy, modify, and/or distribute this software for any
+ * purpose with or without fee is hereby granted.
+
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES WITH
+ * REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY
+ * AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT,
+ * INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM
+ * LOSS OF USE, DATA OR PROFITS, WHETHER IN AN ACTION OF CONTRACT, NEGLIGENCE OR
+ * OTHER TORTIOUS ACTION, ARISING OUT OF OR IN CONNECTION WITH THE USE OR
+ * PERFORMANCE OF THIS SOFTWARE.
+ *
+ */
+
+
+#include "XUiAtlas.h"
+#include "XUiWriteUI.h"
+#include "XUiGenerator.h"
+
+
+/*---------------------------------------------------------------------
+-----------------------------------------------------------------------    
+        pack the png images of a project into a few atlas pages
+-----------------------------------------------------------------------
+----------------------------------------------------------------------*/
+
+#define ATLAS_WIDTH 2048
+#define ATLAS_HEIGHT 4096
+
+// width and height from the IHDR chunk, no need to inflate the image for that
+static int png_size(const char *image, int *width, int *height) {
+    static const unsigned char signature[8] = {0x89, 'P', 'N', 'G', '\r', '\n', 0x1a, '\n'};
+    unsigned char head[24];
+    FILE *fp = fopen(image, "rb");
+    if (fp == NULL) return -1;
+    size_t got = fread(head, 1, sizeof(head), fp);
+    fclose(fp);
+    if (got < sizeof(head) || memcmp(head, signature, 8) || memcmp(head + 12, "IHDR", 4)) return -1;
+    uint32_t w = (uint32_t)head[16] << 24 | (uint32_t)head[17] << 16 | (uint32_t)head[18] << 8 | head[19];
+    uint32_t h = (uint32_t)head[20] << 24 | (uint32_t)head[21] << 16 | (uint32_t)head[22] << 8 | head[23];
+    if (!w || !h || w > 32767 || h > 32767) return -1;
+    *width = (int)w;
+    *height = (int)h;
+    return 0;
+}
+
+void atlas_init(XUiAtlas *atlas) {
+    atlas->entry = NULL;
+    atlas->entries = 0;
+    atlas->page_width = NULL;
+    atlas->page_height = NULL;
+    atlas->pages = 0;
+}
+
+int atlas_find(XUiAtlas *atlas, const char *image) {
+    int i = 0;
+    for (;i<atlas->entries;i++) {
+        if (strcmp(atlas->entry[i].image, image) == 0) return i;
+    }
+    return -1;
+}
+
+static void atlas_add(XUiAtlas *atlas, const char *image) {
+    if (!strstr(image, ".png") || atlas_find(atlas, image) >= 0) return;
+    int width = 0;
+    int height = 0;
+    if (png_size(image, &width, &height)) return;
+    atlas->entry = (AtlasEntry*)realloc(atlas->entry, (atlas->entries+1) * sizeof(AtlasEntry));
+    AtlasEntry *e = &atlas->entry[atlas->entries++];
+    e->image = strdup(image);
+    e->page = -1;
+    e->x = 0;
+    e->y = 0;
+    e->width = width;
+    e->height = height;
+}
+
+static void atlas_add_page(XUiAtlas *atlas) {
+    atlas->page_width = (int*)realloc(atlas->page_width, (atlas->pages+1) * sizeof(int));
+    atlas->page_height = (int*)realloc(atlas->page_height, (atlas->pages+1) * sizeof(int));
+    atlas->page_width[atlas->pages] = 0;
+    atlas->page_height[atlas->pages] = 0;
+    atlas->pages++;
+}
+
+// tallest first keeps the shelves tight, equal heights stay in project order
+static int atlas_order(const void *a, const void *b) {
+    const AtlasEntry *ea = *(const AtlasEntry* const*)a;
+    const AtlasEntry *eb = *(const AtlasEntry* const*)b;
+    if (ea->height != eb->height) return eb->height - ea->height;
+    return (ea > eb) - (ea < eb);
+}
+
+// shelf packing, a sprite strip wider than a page widens all pages
+static void atlas_pack(XUiAtlas *atlas) {
+    if (!atlas->entries) return;
+    AtlasEntry **order = (AtlasEntry**)malloc(atlas->entries * sizeof(AtlasEntry*));
+    int limit = ATLAS_WIDTH;
+    int i = 0;
+    for (;i<atlas->entries;i++) {
+        order[i] = &atlas->entry[i];
+        limit = max(limit, atlas->entry[i].width);
+    }
+    qsort(order, atlas->entries, sizeof(AtlasEntry*), atlas_order);
+    int x = 0;
+    int y = 0;
+    int shelf = 0;
+    atlas_add_page(atlas);
+    for (i=0;i<atlas->entries;i++) {
+        AtlasEntry *e = order[i];
+        if (x + e->width > limit) {
+            y += shelf;
+            x = 0;
+            shelf = 0;
+        }
+        if (y + e->height > ATLAS_HEIGHT && (x > 0 || y > 0)) {
+            atlas_add_page(atlas);
+            x = 0;
+            y = 0;
+            shelf = 0;
+        }
+        int page = atlas->pages - 1;
+        e->page = page;
+        e->x = x;
+        e->y = y;
+        x += e->width;
+        shelf = max(shelf, e->height);
+        atlas->page_width[page] = max(atlas->page_width[page], x);
+        atlas->page_height[page] = max(atlas->page_height[page], y + e->height);
+    }
+    free(order);
+}
+
+// background first, then the controllers, the same project always packs the same way
+// images with the same content share one frame
+void atlas_collect(XUiDesigner *designer, XUiAtlas *atlas) {
+    if (designer->image != NULL) atlas_add(atlas, shared_image(designer, designer->image));
+    int i = 0;
+    for (;i<MAX_CONTROLS;i++) {
+        if (designer->controls[i].wid != NULL && designer->controls[i].image != NULL) {
+            atlas_add(atlas, shared_image(designer, designer->controls[i].image));
+        }
+    }
+    atlas_pack(atlas);
+}
+
+// paint the images of one page together and write it as CairoImageData
+int atlas_compose(XUiAtlas *atlas, int page, const char *name, XUiString *out) {
+    cairo_surface_t *surface = cairo_image_surface_create(CAIRO_FORMAT_ARGB32,
+                        atlas->page_width[page], atlas->page_height[page]);
+    cairo_t *cr = cairo_create(surface);
+    cairo_set_operator(cr, CAIRO_OPERATOR_SOURCE);
+    int ret = 0;
+    int i = 0;
+    for (;i<atlas->entries && !ret;i++) {
+        AtlasEntry *e = &atlas->entry[i];
+        if (e->page != page) continue;
+        cairo_surface_t *png = cairo_image_surface_create_from_png(e->image);
+        if (cairo_surface_status(png) != CAIRO_STATUS_SUCCESS ||
+                cairo_image_surface_get_width(png) != e->width ||
+                cairo_image_surface_get_height(png) != e->height) {
+            ret = -1;
+        } else {
+            cairo_set_source_surface(cr, png, e->x, e->y);
+            cairo_rectangle(cr, e->x, e->y, e->width, e->height);
+            cairo_fill(cr);
+        }
+        cairo_surface_destroy(png);
+    }
+    cairo_destroy(cr);
+    if (!ret) ret = png2c_surface(surface, name, out);
+    cairo_surface_destroy(surface);
+    return ret;
+}
+
+void atlas_free(XUiAtlas *atlas) {
+    int i = 0;
+    for (;i<atlas->entries;i++) {
+        free(atlas->entry[i].image);
+    }
+    free(atlas->entry);
+    free(atlas->page_width);
+    free(atlas->page_height);
+    atlas_init(atlas);
+}
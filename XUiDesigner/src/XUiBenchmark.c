@@ -0,0 +1,269 @@
+/*
+ *                           0BSD 
+ * 
+ *                    BSD Zero Clause License
+ * 
+ *  Copyright (c) 2021 Hermann Meyer
+ *
+ * Permission to use, copy, modify, and/or distribute this software for any
+ * purpose with or without fee is hereby granted.
+
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES WITH
+ * REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY
+ * AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT,
+ * INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM
+ * LOSS OF USE, DATA OR PROFITS, WHETHER IN AN ACTION OF CONTRACT, NEGLIGENCE OR
+ * OTHER TORTIOUS ACTION, ARISING OUT OF OR IN CONNECTION WITH THE USE OR
+ * PERFORMANCE OF THIS SOFTWARE.
+ *
+ */
+
+
+#include <time.h>
+
+#include "XUiBenchmark.h"
+#include "XUiGenerator.h"
+#include "XUiExecutor.h"
+#include "XUiEmbed.h"
+#include "XUiWriteUI.h"
+#include "XUiWritePlugin.h"
+#include "XUiWriteTurtle.h"
+#include "XUiWriteJson.h"
+
+
+/*---------------------------------------------------------------------
+-----------------------------------------------------------------------    
+                measure the time needed to save a large project
+-----------------------------------------------------------------------
+----------------------------------------------------------------------*/
+
+static double bench_clock() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+// a knob sprite strip, each one a bit different
+static char *bench_image(const char *dir, int n) {
+    const int size = 64;
+    const int frames = 101;
+    cairo_surface_t *image = cairo_image_surface_create(CAIRO_FORMAT_ARGB32, size*frames, size);
+    cairo_t *cr = cairo_create(image);
+    int f = 0;
+    for (;f<frames;f++) {
+        cairo_set_source_rgb(cr, (double)n/50.0, (double)f/frames, 0.5);
+        cairo_arc(cr, f*size+size/2, size/2, size/2-4, 0, 2 * M_PI);
+        cairo_fill(cr);
+    }
+    cairo_destroy(cr);
+    char *file = NULL;
+    asprintf(&file, "%s/knob%i.png", dir, n);
+    cairo_surface_write_to_png(image, file);
+    cairo_surface_destroy(image);
+    return file;
+}
+
+typedef struct {
+    const unsigned char *data;
+    size_t size;
+    size_t pos;
+} BenchStream;
+
+static cairo_status_t bench_read(void *closure, unsigned char *data, unsigned int length) {
+    BenchStream *stream = (BenchStream*)closure;
+    if (stream->pos + length > stream->size) return CAIRO_STATUS_READ_ERROR;
+    memcpy(data, stream->data + stream->pos, length);
+    stream->pos += length;
+    return CAIRO_STATUS_SUCCESS;
+}
+
+// what the wrapper does with a loaded image on instantiate
+static void bench_paint(Widget_t *w, cairo_surface_t *image, int width, int height) {
+    cairo_surface_t *target = cairo_surface_create_similar(w->surface,
+                        CAIRO_CONTENT_COLOR_ALPHA, width, height);
+    cairo_t *cr = cairo_create(target);
+    cairo_set_source_surface(cr, image, 0, 0);
+    cairo_paint(cr);
+    cairo_destroy(cr);
+    cairo_surface_destroy(target);
+}
+
+static void bench_json(XUiDesigner *designer, XUiString *out) {
+    print_json(designer, ".", out);
+}
+
+void run_save_benchmark(XUiDesigner *designer, int controls, int images) {
+    char dir[] = "/tmp/xuidesigner-bench-XXXXXX";
+    if (mkdtemp(dir) == NULL) {
+        fprintf(stderr, "benchmark: could not create %s\n", dir);
+        return;
+    }
+    widget_set_title(designer->ui, "benchmark");
+    controls = min(controls, MAX_CONTROLS - designer->wid_counter);
+    int i = 0;
+    for (;i<controls;i++) {
+        asprintf(&designer->controls[designer->wid_counter].name, "Knob%i", i);
+        Widget_t *wid = add_knob(designer->ui, designer->controls[designer->wid_counter].name,
+                                                    (i%20)*70, (i/20)*90, 60, 80);
+        set_adjustment(wid->adj, 0.5, 0.5, 0.0, 1.0, 0.01, CL_CONTINUOS);
+        set_controller_callbacks(designer, wid, true);
+        add_to_list(designer, wid, "add_lv2_knob", true, IS_KNOB);
+        if (i < images) designer->controls[wid->data].image = bench_image(dir, i);
+    }
+
+    // embed the sprites the old way, one xxd process per image, and in process
+    int embedded = min(images, controls);
+    size_t size = 0;
+    char *cmd = NULL;
+    double t = bench_clock();
+    for (i=0;i<embedded;i++) {
+        asprintf(&cmd, "cd %s && xxd -i knob%i.png > knob%i_xxd.c", dir, i, i);
+        if (system(cmd)) fprintf(stderr, "benchmark: xxd failed\n");
+        free(cmd);
+        cmd = NULL;
+    }
+    double shell = bench_clock() - t;
+    t = bench_clock();
+    for (i=0;i<embedded;i++) {
+        unsigned char *data = NULL;
+        char *file = NULL;
+        char *var = NULL;
+        asprintf(&file, "%s/knob%i.png", dir, i);
+        asprintf(&var, "knob%i_png", i);
+        if (!embed_read_file(file, &data, &size)) {
+            XUiString out;
+            xstring_init(&out);
+            embed_c_array(&out, var, data, size);
+            strdecode(file, ".png", "_embed.c");
+            xstring_write_file(&out, file);
+            xstring_free(&out);
+        }
+        free(data);
+        free(file);
+        free(var);
+    }
+    double embed = bench_clock() - t;
+
+    // instantiate cost per sprite, inflate the embedded png or wrap the pixels png2c stored
+    double png_load = 0.0;
+    double pixel_load = 0.0;
+    for (i=0;i<embedded;i++) {
+        unsigned char *data = NULL;
+        char *file = NULL;
+        asprintf(&file, "%s/knob%i.png", dir, i);
+        if (embed_read_file(file, &data, &size)) {
+            free(file);
+            continue;
+        }
+        cairo_surface_t *decoded = cairo_image_surface_create_from_png(file);
+        cairo_surface_flush(decoded);
+        int width = cairo_image_surface_get_width(decoded);
+        int height = cairo_image_surface_get_height(decoded);
+        t = bench_clock();
+        BenchStream stream = {data, size, 0};
+        cairo_surface_t *png = cairo_image_surface_create_from_png_stream(bench_read, &stream);
+        bench_paint(designer->ui, png, width, height);
+        cairo_surface_destroy(png);
+        png_load += bench_clock() - t;
+        t = bench_clock();
+        cairo_surface_t *pixels = cairo_image_surface_create_for_data(
+            cairo_image_surface_get_data(decoded), CAIRO_FORMAT_ARGB32,
+            width, height, cairo_image_surface_get_stride(decoded));
+        bench_paint(designer->ui, pixels, width, height);
+        cairo_surface_destroy(pixels);
+        pixel_load += bench_clock() - t;
+        cairo_surface_destroy(decoded);
+        free(data);
+        free(file);
+    }
+
+    // the generators one after the other on the UI thread
+    t = bench_clock();
+    generate_func generators[] = {print_list, print_plugin, print_ttl, print_manifest,
+                                                        print_makefile, bench_json};
+    for (i=0;i<(int)(sizeof(generators)/sizeof(generators[0]));i++) {
+        free(generate_text(designer, generators[i], &size));
+    }
+    double serial = bench_clock() - t;
+
+    // the whole save, offline, without setting up a repository
+    char *path = NULL;
+    asprintf(&path, "%s/", dir);
+    designer->generate_ui_only = false;
+    designer->regenerate_ui = false;
+    RepoSetup repo_setup = designer->repo_setup;
+    designer->repo_setup = REPO_SKIP;
+    t = bench_clock();
+    run_save(designer->save, (void*)&path);
+    double snapshot = bench_clock() - t;
+    if (designer->save_job) executor_wait(designer->executor, designer->save_job);
+    double save = bench_clock() - t;
+    designer->repo_setup = repo_setup;
+    free(path);
+
+    fprintf(stderr, "benchmark: %i controls, %i images\n", controls, embedded);
+    fprintf(stderr, "benchmark: embed %i sprites with xxd %.1f ms, in process %.1f ms\n",
+                                        embedded, shell * 1000.0, embed * 1000.0);
+    fprintf(stderr, "benchmark: instantiate %i sprites from png %.1f ms, from pixels %.1f ms\n",
+                                        embedded, png_load * 1000.0, pixel_load * 1000.0);
+    fprintf(stderr, "benchmark: generators in sequence %.1f ms\n", serial * 1000.0);
+    fprintf(stderr, "benchmark: save snapshot %.1f ms, total %.1f ms\n", snapshot * 1000.0, save * 1000.0);
+    fprintf(stderr, "benchmark: bundle written to %s/benchmark_ui\n", dir);
+}
+
+/*---------------------------------------------------------------------
+-----------------------------------------------------------------------    
+                save the same project twice and compare the json
+-----------------------------------------------------------------------
+----------------------------------------------------------------------*/
+
+// the generators run side by side, so a save must not depend on their timing
+static unsigned char *check_save(XUiDesigner *designer, const char *dir, size_t *size) {
+    char *path = NULL;
+    asprintf(&path, "%s/", dir);
+    run_save(designer->save, (void*)&path);
+    if (designer->save_job) executor_wait(designer->executor, designer->save_job);
+    free(path);
+    char *file = NULL;
+    unsigned char *data = NULL;
+    asprintf(&file, "%s/savecheck_ui/savecheck.json", dir);
+    if (embed_read_file(file, &data, size)) data = NULL;
+    free(file);
+    return data;
+}
+
+int run_save_check(XUiDesigner *designer) {
+    char dir[] = "/tmp/xuidesigner-check-XXXXXX";
+    if (mkdtemp(dir) == NULL) {
+        fprintf(stderr, "save check: could not create %s\n", dir);
+        return 1;
+    }
+    widget_set_title(designer->ui, "savecheck");
+    // labels which need a sanitized lv2:symbol
+    int controls = min(40, MAX_CONTROLS - designer->wid_counter);
+    int i = 0;
+    for (;i<controls;i++) {
+        asprintf(&designer->controls[designer->wid_counter].name, "Gain %i (dB)", i);
+        Widget_t *wid = add_knob(designer->ui, designer->controls[designer->wid_counter].name,
+                                                    (i%20)*70, (i/20)*90, 60, 80);
+        set_adjustment(wid->adj, 0.5, 0.5, 0.0, 1.0, 0.01, CL_CONTINUOS);
+        set_controller_callbacks(designer, wid, true);
+        add_to_list(designer, wid, "add_lv2_knob", true, IS_KNOB);
+    }
+    designer->generate_ui_only = false;
+    designer->regenerate_ui = false;
+    RepoSetup repo_setup = designer->repo_setup;
+    designer->repo_setup = REPO_SKIP;
+    size_t first_size = 0;
+    size_t second_size = 0;
+    unsigned char *first = check_save(designer, dir, &first_size);
+    unsigned char *second = check_save(designer, dir, &second_size);
+    designer->repo_setup = repo_setup;
+    int ret = !first || !second || first_size != second_size ||
+                                    memcmp(first, second, first_size);
+    fprintf(stderr, "save check: json of two saves %s (%s/savecheck_ui)\n",
+                                    ret ? "differ" : "match", dir);
+    free(first);
+    free(second);
+    return ret;
+}
@@ -328,6 +328,7 @@ static void set_costum_color(XUiDesigner *designer, ColorChooser_t *color_choose
         default:
         break;
     }
+    designer_changed(designer);
 }
 
 static void set_rgba_color(XUiDesigner *designer, ColorChooser_t *color_chooser,
@@ -341,6 +342,7 @@ static void set_rgba_color(XUiDesigner *designer, ColorChooser_t *color_chooser,
     if (adj_get_value(designer->global_color->adj) ||
         designer->controls[designer->active_widget_num].is_type == IS_COMBOBOX)
         color_scheme_to_childs(get_active_widget(designer));
+    designer_changed(designer);
 }
 
 static void a_callback(void *w_, void* UNUSED(user_data)) {
@@ -432,6 +434,7 @@ static void reset_plugin_colors(void *w_, void* UNUSED(user_data)) {
         color_scheme_to_childs(designer->ui);
         expose_widget(designer->ui);
         set_selected_color_on_map(w, NULL);
+        designer_changed(designer);
     }
 }
 
@@ -19,6 +19,7 @@
  */
 
 #include "XUiConfig.h"
+#include "XUiString.h"
 
 
 /*---------------------------------------------------------------------
@@ -28,39 +29,50 @@
 ----------------------------------------------------------------------*/
 
 
+// in the order of RepoSetup
+static const char *repo_setup_names[] = {"submodule", "mirror", "vendor", "skip"};
+
 void save_config(XUiDesigner *designer) {
     char* config_file = NULL;
     asprintf(&config_file, "%s/.config/xuidesigner.conf", getenv("HOME"));
-    FILE *fpm;
-    if((fpm=freopen(config_file, "w" ,stdout))==NULL) {
-        printf("Error opening config file\n");
-        return;
-    }
+    XUiString config;
+    XUiString *out = &config;
+    xstring_init(out);
     if (designer->global_knob_image_file) {
-        printf("[Global Knob Image]=%s\n", designer->global_knob_image_file);
+        xstring_printf(out, "[Global Knob Image]=%s\n", designer->global_knob_image_file);
     }
     if (designer->global_button_image_file) {
-        printf("[Global Button Image]=%s\n", designer->global_button_image_file);
+        xstring_printf(out, "[Global Button Image]=%s\n", designer->global_button_image_file);
     }
     if (designer->global_switch_image_file) {
-        printf("[Global Switch Image]=%s\n", designer->global_switch_image_file);
+        xstring_printf(out, "[Global Switch Image]=%s\n", designer->global_switch_image_file);
     }
     if (designer->global_vslider_image_file) {
-        printf("[Global VSlider Image]=%s\n", designer->global_vslider_image_file);
+        xstring_printf(out, "[Global VSlider Image]=%s\n", designer->global_vslider_image_file);
     }
     if (designer->global_hslider_image_file) {
-        printf("[Global HSlider Image]=%s\n", designer->global_hslider_image_file);
+        xstring_printf(out, "[Global HSlider Image]=%s\n", designer->global_hslider_image_file);
     }
-    printf("[Use Global Knob Image]=%f\n", adj_get_value(designer->global_knob_image->adj));
-    printf("[Use Global Button Image]=%f\n", adj_get_value(designer->global_button_image->adj));
-    printf("[Use Global Switch Image]=%f\n", adj_get_value(designer->global_switch_image->adj));
-    printf("[Use Global VSlider Image]=%f\n", adj_get_value(designer->global_vslider_image->adj));
-    printf("[Use Global HSlider Image]=%f\n", adj_get_value(designer->global_hslider_image->adj));
-    printf("[Global VSlider Sprites]=%i\n", designer->global_vslider_image_sprites);
-    printf("[Global HSlider Sprites]=%i\n", designer->global_hslider_image_sprites);
-    printf("[Keep Aspect Ratio]=%f\n", adj_get_value(designer->aspect_ratio->adj));
-    printf("[Use Global Size]=%f\n", adj_get_value(designer->resize_all->adj));
-    fclose(fpm);
+    xstring_printf(out, "[Use Global Knob Image]=%f\n", adj_get_value(designer->global_knob_image->adj));
+    xstring_printf(out, "[Use Global Button Image]=%f\n", adj_get_value(designer->global_button_image->adj));
+    xstring_printf(out, "[Use Global Switch Image]=%f\n", adj_get_value(designer->global_switch_image->adj));
+    xstring_printf(out, "[Use Global VSlider Image]=%f\n", adj_get_value(designer->global_vslider_image->adj));
+    xstring_printf(out, "[Use Global HSlider Image]=%f\n", adj_get_value(designer->global_hslider_image->adj));
+    xstring_printf(out, "[Global VSlider Sprites]=%i\n", designer->global_vslider_image_sprites);
+    xstring_printf(out, "[Global HSlider Sprites]=%i\n", designer->global_hslider_image_sprites);
+    xstring_printf(out, "[Keep Aspect Ratio]=%f\n", adj_get_value(designer->aspect_ratio->adj));
+    xstring_printf(out, "[Use Global Size]=%f\n", adj_get_value(designer->resize_all->adj));
+    xstring_printf(out, "[Startup Images]=%f\n", adj_get_value(designer->startup_images->adj));
+    xstring_printf(out, "[Lazy Tabs]=%f\n", adj_get_value(designer->lazy_tabs->adj));
+    xstring_printf(out, "[Layout Table]=%f\n", adj_get_value(designer->layout_table->adj));
+    xstring_printf(out, "[Repository Setup]=%s\n", repo_setup_names[designer->repo_setup]);
+    if (designer->libxputty_path) {
+        xstring_printf(out, "[Libxputty Path]=%s\n", designer->libxputty_path);
+    }
+    if (xstring_write_file(out, config_file)) {
+        fprintf(stderr, "Error opening config file\n");
+    }
+    xstring_free(out);
     free(config_file);
 }
 
@@ -68,12 +80,12 @@ void read_config(XUiDesigner *designer) {
     char* config_file = NULL;
     asprintf(&config_file, "%s/.config/xuidesigner.conf", getenv("HOME"));
     FILE *fpm;
-    char buf[128];
+    char buf[PATH_MAX + 32];
     if((fpm = fopen(config_file, "r")) == NULL) {
-        printf("Error opening config file!\n");
+        fprintf(stderr, "Error opening config file!\n");
         return;
     }
-    while (fgets(buf, 128, fpm) != NULL) {
+    while (fgets(buf, sizeof(buf), fpm) != NULL) {
         char *ptr = strtok(buf, "=");
         while(ptr != NULL) {
             if (strstr(ptr, "[Global Knob Image]") != NULL) {
@@ -122,6 +134,26 @@ void read_config(XUiDesigner *designer) {
             } else if (strstr(ptr, "[Use Global Size]") != NULL) {
                 ptr = strtok(NULL, "\n");
                 adj_set_value(designer->resize_all->adj, strtod(ptr, NULL));
+            } else if (strstr(ptr, "[Startup Images]") != NULL) {
+                ptr = strtok(NULL, "\n");
+                adj_set_value(designer->startup_images->adj, strtod(ptr, NULL));
+            } else if (strstr(ptr, "[Lazy Tabs]") != NULL) {
+                ptr = strtok(NULL, "\n");
+                adj_set_value(designer->lazy_tabs->adj, strtod(ptr, NULL));
+            } else if (strstr(ptr, "[Layout Table]") != NULL) {
+                ptr = strtok(NULL, "\n");
+                adj_set_value(designer->layout_table->adj, strtod(ptr, NULL));
+            } else if (strstr(ptr, "[Repository Setup]") != NULL) {
+                ptr = strtok(NULL, "\n");
+                int i = 0;
+                for (;ptr != NULL && i<(int)(sizeof(repo_setup_names)/sizeof(repo_setup_names[0]));i++) {
+                    if (strcmp(ptr, repo_setup_names[i]) == 0) designer->repo_setup = (RepoSetup)i;
+                }
+            } else if (strstr(ptr, "[Libxputty Path]") != NULL) {
+                free(designer->libxputty_path);
+                designer->libxputty_path = NULL;
+                ptr = strtok(NULL, "\n");
+                asprintf(&designer->libxputty_path, "%s", ptr);
             } else if (strstr(ptr, "[Global VSlider Sprites]") != NULL) {
                 ptr = strtok(NULL, "\n");
                 designer->global_vslider_image_sprites = strtod(ptr, NULL);
@@ -36,6 +36,10 @@
 #include "XUiFileParser.h"
 #include "XUiDraw.h"
 #include "XUiMultiSelect.h"
+#include "XUiScheduler.h"
+#include "XUiExecutor.h"
+#include "XUiBenchmark.h"
+#include "XUiLivePreview.h"
 
 #include "xtabbox_private.h"
 
@@ -145,6 +149,7 @@ static void set_controller_adjustment(void *w_, void* UNUSED(user_data)) {
             if (strlen(text_box->input_label)>1) {
                 designer->active_widget->adj->step = atof(text_box->input_label);
             }
+            designer_changed(designer);
         }
     }
 }
@@ -343,6 +348,7 @@ static void set_port_index(void *w_, void* UNUSED(user_data)) {
         if (designer->active_widget != NULL) {
             designer->controls[designer->active_widget_num].port_index =
                 (int)adj_get_value(designer->index->adj);
+            designer_changed(designer);
         }
     }
 }
@@ -614,7 +620,7 @@ void move_wid(void *w_, void *xmotion_, void* UNUSED(user_data)) {
             designer->pos_y = xmotion->y_root;
             if (designer->controls[w->data].is_type == IS_TABBOX ||
                     designer->controls[w->data].is_type == IS_FRAME) {
-                expose_widget(designer->ui);
+                scheduler_queue_redraw(designer->scheduler, designer->ui);
             }
         }
         break;
@@ -643,7 +649,7 @@ void move_wid(void *w_, void *xmotion_, void* UNUSED(user_data)) {
             designer->pos_x = xmotion->x_root;
             if (designer->controls[w->data].is_type == IS_TABBOX ||
                     designer->controls[w->data].is_type == IS_FRAME) {
-                expose_widget(designer->ui);
+                scheduler_queue_redraw(designer->scheduler, designer->ui);
             }
         }
         break;
@@ -672,7 +678,7 @@ void move_wid(void *w_, void *xmotion_, void* UNUSED(user_data)) {
             designer->pos_y = xmotion->y_root;
             if (designer->controls[w->data].is_type == IS_TABBOX ||
                     designer->controls[w->data].is_type == IS_FRAME) {
-                expose_widget(designer->ui);
+                scheduler_queue_redraw(designer->scheduler, designer->ui);
             }
         }
         break;
@@ -708,6 +714,12 @@ void move_wid(void *w_, void *xmotion_, void* UNUSED(user_data)) {
     }
 }
 
+// the plugin window size is part of the generated files
+static void ui_configured(void *w_, void* UNUSED(user_data)) {
+    Widget_t *w = (Widget_t*)w_;
+    designer_changed((XUiDesigner*)w->parent_struct);
+}
+
 static void set_cursor(void *w_, void* UNUSED(user_data)) {
     Widget_t *w = (Widget_t*)w_;
     XUiDesigner *designer = (XUiDesigner*)w->parent_struct;
@@ -786,6 +798,7 @@ void fix_pos_wid(void *w_, void *button_, void* UNUSED(user_data)) {
     XUiDesigner *designer = (XUiDesigner*)p->parent_struct;
     XButtonEvent *xbutton = (XButtonEvent*)button_;
     if(xbutton->button == Button1) {
+        designer_changed(designer);
         if (adj_get_value(designer->move_all->adj)) {
             fix_pos_for_all(designer, designer->controls[w->data].is_type);
             return;
@@ -1000,6 +1013,7 @@ static void update_clabel(void *w_, void* UNUSED(user_data)) {
         designer->active_widget->label = (const char*)designer->new_label[designer->active_widget_num];
     }
     expose_widget(designer->active_widget);
+    designer_changed(designer);
 }
 
 static void run_exit(void *w_, void* UNUSED(user_data)) {
@@ -1082,11 +1096,20 @@ static void ask_save_as(void *w_, void* UNUSED(user_data)) {
 -----------------------------------------------------------------------
 ----------------------------------------------------------------------*/
 
-void *reset_flag(void *designer_) {
+static void reset_flag(void *designer_) {
     XUiDesigner *designer = (XUiDesigner*)designer_;
-    usleep(1*1000*1000); // 1sec
     designer->ui->flags &= ~FAST_REDRAW;
-    pthread_exit(NULL);
+}
+
+// clear FAST_REDRAW one second after the last load finished
+void reset_fast_redraw(XUiDesigner *designer) {
+    scheduler_timeout(designer->scheduler, 1000, reset_flag, designer);
+}
+
+// an edit changed the project, refresh the text views and the live preview
+void designer_changed(XUiDesigner *designer) {
+    preview_notify_changed(designer);
+    live_preview_changed(designer->live_preview);
 }
 
 void load_lv2_ui(void *w_, void* UNUSED(user_data)) {
@@ -1097,19 +1120,23 @@ void load_lv2_ui(void *w_, void* UNUSED(user_data)) {
         widget_show_all(designer->ui);
         XResizeWindow(designer->ui->app->dpy, designer->ui->widget, designer->ui->width, designer->ui->height-1);
     }
-    pthread_t rf;
-    pthread_create(&rf, NULL, reset_flag, (void *)designer);
+    reset_fast_redraw(designer);
 }
 
-void load_lv2_uris (XUiDesigner *designer) {
-    designer->lv2_names->func.value_changed_callback = null_callback;
-    designer->world = lilv_world_new();
-    if (designer->path !=NULL) set_path(designer->world, designer->path);
-    LilvNode* false_val = lilv_new_bool(designer->world, false);
-    lilv_world_set_option(designer->world,LILV_OPTION_DYN_MANIFEST, false_val);
-    lilv_world_load_all(designer->world);
-    designer->lv2_plugins = lilv_world_get_all_plugins(designer->world);
+static LilvWorld *new_lv2_world(const char *path) {
+    LilvWorld *world = lilv_world_new();
+    if (path !=NULL) set_path(world, path);
+    LilvNode* false_val = lilv_new_bool(world, false);
+    lilv_world_set_option(world,LILV_OPTION_DYN_MANIFEST, false_val);
     lilv_node_free(false_val);
+    return world;
+}
+
+static void set_lv2_world(XUiDesigner *designer, LilvWorld *world, const LilvPlugins *plugins) {
+    designer->lv2_names->func.value_changed_callback = null_callback;
+    if (designer->world && designer->world != world) lilv_world_free(designer->world);
+    designer->world = world;
+    designer->lv2_plugins = plugins;
     load_uris(designer->lv2_uris, designer->lv2_names, designer->lv2_plugins);
     combobox_set_active_entry(designer->lv2_names, 0);
     combobox_set_active_entry(designer->lv2_uris, 0);
@@ -1117,13 +1144,75 @@ void load_lv2_uris (XUiDesigner *designer) {
     designer->lv2_names->func.value_changed_callback = load_lv2_ui;
 }
 
+typedef struct {
+    XUiDesigner *designer;
+    LilvWorld *world;
+    const LilvPlugins *plugins;
+    char *path;
+} WorldLoad;
+
+static void lv2_world_load(XUiJob *job, void *data) {
+    WorldLoad *wl = (WorldLoad*)data;
+    wl->world = new_lv2_world(wl->path);
+    lilv_world_load_all(wl->world);
+    wl->plugins = lilv_world_get_all_plugins(wl->world);
+    // plugin data gets loaded on first access, do that here and not on the UI thread
+    for (LilvIter* it = lilv_plugins_begin(wl->plugins);
+      !lilv_plugins_is_end(wl->plugins, it) && !job_is_cancelled(job);
+      it = lilv_plugins_next(wl->plugins, it)) {
+        const LilvPlugin* plugin = lilv_plugins_get(wl->plugins, it);
+        if (plugin) lilv_node_free(lilv_plugin_get_name(plugin));
+    }
+}
+
+static void lv2_world_loaded(XUiJob *job, void *data) {
+    WorldLoad *wl = (WorldLoad*)data;
+    XUiDesigner *designer = wl->designer;
+    if (designer->world_job == job) designer->world_job = NULL;
+    if (job_is_cancelled(job) || designer->world) {
+        lilv_world_free(wl->world);
+    } else {
+        set_lv2_world(designer, wl->world, wl->plugins);
+    }
+    free(wl->path);
+    free(wl);
+}
+
+void load_lv2_uris_async(XUiDesigner *designer) {
+    if (designer->world || designer->world_job) return;
+    WorldLoad *wl = (WorldLoad*)malloc(sizeof(WorldLoad));
+    wl->designer = designer;
+    wl->world = NULL;
+    wl->plugins = NULL;
+    wl->path = designer->path ? strdup(designer->path) : NULL;
+    designer->world_job = executor_submit(designer->executor, lv2_world_load,
+                                                lv2_world_loaded, NULL, wl);
+}
+
+void load_lv2_uris (XUiDesigner *designer) {
+    // a load in flight would be thrown away, drop it instead of waiting for it
+    if (designer->world_job) {
+        job_cancel(designer->world_job);
+        designer->world_job = NULL;
+    }
+    LilvWorld *world = new_lv2_world(designer->path);
+    lilv_world_load_all(world);
+    set_lv2_world(designer, world, lilv_world_get_all_plugins(world));
+}
+
+// take the world from the background load when it is on the way
+static void check_lv2_world(XUiDesigner *designer) {
+    if (designer->world_job) executor_wait(designer->executor, designer->world_job);
+    if (!designer->world) load_lv2_uris (designer);
+}
+
 static void filter_plugin_name(void *w_, void* UNUSED(user_data)) {
     Widget_t *w = (Widget_t*)w_;
     XUiDesigner *designer = (XUiDesigner*)w->parent_struct;
     TextBox_t *text_box = (TextBox_t*)designer->filter_by_word->private_struct;
     designer->lv2_names->func.value_changed_callback = null_callback;
     if (strlen(text_box->input_label)) {
-        if (!designer->world) load_lv2_uris (designer);
+        check_lv2_world(designer);
         filter_uris_by_word(designer->lv2_uris, designer->lv2_names, 
                         designer->lv2_plugins, text_box->input_label);
     } else {
@@ -1144,7 +1233,7 @@ static void filter_plugin_ui(void *w_, void* UNUSED(user_data)) {
     Widget_t *w = (Widget_t*)w_;
     XUiDesigner *designer = (XUiDesigner*)w->parent_struct;
     if (w->flags & HAS_POINTER && adj_get_value(w->adj_y)) {
-        if (!designer->world) load_lv2_uris (designer);
+        check_lv2_world(designer);
         filter_uris(designer->lv2_uris, designer->lv2_names, designer->lv2_plugins);
     } else if (w->flags & HAS_POINTER && !adj_get_value(w->adj_y)) {
         combobox_delete_entrys(designer->lv2_uris);
@@ -1161,7 +1250,7 @@ static void filter_plugin_ui(void *w_, void* UNUSED(user_data)) {
 static void check_world(void *w_, void* UNUSED(button_), void* UNUSED(user_data)) {
     Widget_t *w = (Widget_t*)w_;
     XUiDesigner *designer = (XUiDesigner*)w->parent_struct;
-    if (!designer->world) load_lv2_uris (designer);
+    check_lv2_world(designer);
 }
 
 /*---------------------------------------------------------------------
@@ -1215,18 +1304,27 @@ int main (int argc, char ** argv) {
     extern char *optarg;
     char *path = NULL;
     char *ffile = NULL;
+    bool benchmark = false;
+    bool save_check = false;
+    int ret = 0;
     int a = 0;
     static char usage[] = "usage: %s \n"
     "[-p path] optional set a path to open a ttl file from\n"
-    "[-f faust] optional set a faust *.dsp file to parse from\n";
+    "[-f faust] optional set a faust *.dsp file to parse from\n"
+    "[-b] save a project with 200 controls and 50 images, print the timings and exit\n"
+    "[-s] save a project twice, exit with 1 when the json of both saves differ\n";
 
-    while ((a = getopt(argc, argv, "p:f:h?")) != -1) {
+    while ((a = getopt(argc, argv, "p:f:bsh?")) != -1) {
         switch (a) {
             break;
             case 'p': path = optarg;
             break;
             case 'f': ffile = optarg;
             break;
+            case 'b': benchmark = true;
+            break;
+            case 's': save_check = true;
+            break;
             case 'h':
             case '?': fprintf(stderr, usage, argv[0]);
                 exit(1);
@@ -1259,6 +1357,8 @@ int main (int argc, char ** argv) {
     designer->global_hslider_image_sprites = 101;
     designer->json_file_path = NULL;
     designer->run_test = false;
+    designer->ttlfile_view = NULL;
+    designer->ttlfile_view_mapped = false;
     designer->lv2c.ui_uri = NULL;
     asprintf(&designer->lv2c.ui_uri, "urn:%s:%s", getUserName(), "test_ui");
     designer->lv2c.uri = NULL;
@@ -1326,13 +1426,28 @@ int main (int argc, char ** argv) {
         designer->controls[m].symbol = NULL;
         designer->controls[m].is_type = IS_NONE;
         designer->controls[m].slider_image_sprites = 101;
+        designer->controls[m].sprites.frame = NULL;
+        designer->controls[m].sprites.count = 0;
+        designer->controls[m].sprites.expose = NULL;
         designer->controls[m].have_adjustment = false;
     }
 
     Xputty app;
+    // the save pipeline runs the generators on worker threads
+    XInitThreads();
     main_init(&app);
     //set_light_theme(&app);
     designer->w = create_window(&app, DefaultRootWindow(app.dpy), 0, 0, 1200, 800);
+    designer->scheduler = scheduler_new(&app, designer->w->widget);
+    designer->executor = executor_new(designer->scheduler, 0);
+    designer->world_job = NULL;
+    designer->save_job = NULL;
+    designer->test_job = NULL;
+    designer->shared_image = NULL;
+    designer->live_preview = NULL;
+    designer->shared_images = 0;
+    designer->repo_setup = REPO_SUBMODULE;
+    designer->libxputty_path = NULL;
     designer->w->parent_struct = designer;
     designer->w->flags |= DONT_PROPAGATE;
     widget_set_title(designer->w, _("XUiDesigner"));
@@ -1391,6 +1506,7 @@ int main (int argc, char ** argv) {
     designer->ui->func.leave_callback = unset_cursor;
     designer->ui->func.motion_callback = set_drag_icon;
     designer->ui->func.map_notify_callback = transparent_draw;
+    designer->ui->func.configure_notify_callback = ui_configured;
 
     designer->widgets = add_combobox(designer->w, "", 20, 25, 120, 30);
     designer->widgets->scale.gravity = CENTER;
@@ -1461,7 +1577,7 @@ int main (int argc, char ** argv) {
 
     designer->ttlfile = add_button(designer->w, "", 960, 740, 40, 40);
     widget_get_png(designer->ttlfile, LDVAR(file_png));
-    tooltip_set_text(designer->ttlfile,_("Show ttl file"));
+    tooltip_set_text(designer->ttlfile,_("Show generated files"));
     designer->ttlfile->parent_struct = designer;
     designer->ttlfile->func.value_changed_callback = run_generate_ttl;
 
@@ -1477,6 +1593,8 @@ int main (int argc, char ** argv) {
     designer->save->parent_struct = designer;
     designer->save->func.value_changed_callback = ask_save_as;
 
+    designer->save_status = add_label(designer->w, "", 1000, 700, 180, 30);
+
     designer->exit = add_button(designer->w, "", 1140, 740, 40, 40);
     widget_get_png(designer->exit, LDVAR(exit_png));
     tooltip_set_text(designer->exit,_("Exit"));
@@ -1534,6 +1652,18 @@ int main (int argc, char ** argv) {
     tooltip_set_text(designer->move_all,_("Move all Controller of the same type"));
     designer->move_all->parent_struct = designer;
 
+    designer->startup_images = add_check_box(designer->w, _("  Startup Images"), 1020, 670, 180, 20);
+    tooltip_set_text(designer->startup_images,_("Store PNG images decoded, the generated UI opens without unpacking them"));
+    designer->startup_images->parent_struct = designer;
+
+    designer->lazy_tabs = add_check_box(designer->w, _("  Lazy Tabs"), 1020, 645, 180, 20);
+    tooltip_set_text(designer->lazy_tabs,_("Create the widgets of a tab page when the page is shown the first time"));
+    designer->lazy_tabs->parent_struct = designer;
+
+    designer->layout_table = add_check_box(designer->w, _("  Layout Table"), 1020, 620, 180, 20);
+    tooltip_set_text(designer->layout_table,_("Describe the widgets in a table instead of generating a call sequence for each"));
+    designer->layout_table->parent_struct = designer;
+
     designer->global_knob_image = add_check_box(designer->w, _("Use Global Knob Image"), 1000, 450, 180, 20);
     tooltip_set_text(designer->global_knob_image,_("Use the Image loaded on one Knob for all Knobs"));
     designer->global_knob_image->parent_struct = designer;
@@ -1595,13 +1725,20 @@ int main (int argc, char ** argv) {
     hide_show_as_needed(designer);
     read_config(designer);
     if (ffile != NULL) parse_faust_file(designer, ffile);
-    main_run(&app);
+    load_lv2_uris_async(designer);
+    if (benchmark) run_save_benchmark(designer, 200, 50);
+    else if (save_check) ret = run_save_check(designer);
+    else scheduler_run(designer->scheduler);
 
     save_config(designer);
+    live_preview_free(designer->live_preview);
     //print_ttl(designer);
+    executor_free(designer->executor);
     lilv_world_free(designer->world);
     fprintf(stderr, "bye, bye\n");
+    sprite_frames_free_all(designer);
     main_quit(&app);
+    scheduler_free(designer->scheduler);
     cairo_surface_destroy(designer->grid_image);
     int i = 0;
     for (;i<MAX_CONTROLS; i++) {
@@ -1638,12 +1775,14 @@ int main (int argc, char ** argv) {
     free(designer->lv2c.plugintype);
     free(designer->lv2c.symbol);
     free(designer->path);
+    free_shared_images(designer);
+    free(designer->libxputty_path);
     m = 0;
     for (;m<MAX_CONTROLS;m++) {
         free(designer->controls[m].image);
     }
     free(designer);
 
-    return 0;
+    return ret;
 }
     
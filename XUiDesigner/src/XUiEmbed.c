@@ -0,0 +1,148 @@
+/*
+ *                           0BSD 
+ * 
+ *                    BSD Zero Clause License
+ * 
+ *  Copyright (c) 2021 Hermann Meyer
+ *
+ * Permission to use, copy, modify, and/or distribute this software for any
+ * purpose with or without fee is hereby granted.
+
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES WITH
+ * REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY
+ * AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT,
+ * INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM
+ * LOSS OF USE, DATA OR PROFITS, WHETHER IN AN ACTION OF CONTRACT, NEGLIGENCE OR
+ * OTHER TORTIOUS ACTION, ARISING OUT OF OR IN CONNECTION WITH THE USE OR
+ * PERFORMANCE OF THIS SOFTWARE.
+ *
+ */
+
+
+#include "XUiEmbed.h"
+
+
+/*---------------------------------------------------------------------
+-----------------------------------------------------------------------    
+            embed resource files as C source, in process
+-----------------------------------------------------------------------
+----------------------------------------------------------------------*/
+
+#define BYTES_PER_LINE 12
+#define MAX_PER_LINE 32
+
+// read the whole file with one call, the caller frees data
+int embed_read_file(const char *filename, unsigned char **data, size_t *size) {
+    *data = NULL;
+    *size = 0;
+    FILE *fp = fopen(filename, "rb");
+    if (fp == NULL) return -1;
+    if (fseek(fp, 0, SEEK_END) == -1) {
+        fclose(fp);
+        return -1;
+    }
+    long len = ftell(fp);
+    rewind(fp);
+    if (len < 0) {
+        fclose(fp);
+        return -1;
+    }
+    *data = (unsigned char*)malloc(len ? len : 1);
+    *size = fread(*data, 1, len, fp);
+    fclose(fp);
+    if (*size != (size_t)len) {
+        free(*data);
+        *data = NULL;
+        *size = 0;
+        return -1;
+    }
+    return 0;
+}
+
+static const char hex[] = "0123456789abcdef";
+
+// format a line at a time into a local buffer, more: a comma follows the last byte
+void embed_hex_bytes(XUiString *out, const unsigned char *data, size_t size, int per_line, bool more) {
+    char line[MAX_PER_LINE * 6 + 4];
+    per_line = min(max(1, per_line), MAX_PER_LINE);
+    size_t i = 0;
+    while (i < size) {
+        char *p = line;
+        *p++ = ' ';
+        *p++ = ' ';
+        size_t end = i + per_line < size ? i + per_line : size;
+        for (;i<end;i++) {
+            *p++ = '0';
+            *p++ = 'x';
+            *p++ = hex[data[i] >> 4];
+            *p++ = hex[data[i] & 0x0f];
+            if (i + 1 < size || more) {
+                *p++ = ',';
+                if (i + 1 < end) *p++ = ' ';
+            }
+        }
+        *p++ = '\n';
+        xstring_append_len(out, line, p - line);
+    }
+}
+
+void embed_hex_words(XUiString *out, const uint32_t *data, size_t count, int per_line, bool more) {
+    char line[MAX_PER_LINE * 12 + 4];
+    per_line = min(max(1, per_line), MAX_PER_LINE);
+    size_t i = 0;
+    while (i < count) {
+        char *p = line;
+        *p++ = ' ';
+        *p++ = ' ';
+        size_t end = i + per_line < count ? i + per_line : count;
+        for (;i<end;i++) {
+            *p++ = '0';
+            *p++ = 'x';
+            int shift = 28;
+            for (;shift>=0;shift-=4) *p++ = hex[(data[i] >> shift) & 0x0f];
+            if (i + 1 < count || more) {
+                *p++ = ',';
+                if (i + 1 < end) *p++ = ' ';
+            }
+        }
+        *p++ = '\n';
+        xstring_append_len(out, line, p - line);
+    }
+}
+
+// same layout as xxd -i
+void embed_c_array(XUiString *out, const char *name, const unsigned char *data, size_t size) {
+    xstring_printf(out, "unsigned char %s[] = {\n", name);
+    embed_hex_bytes(out, data, size, BYTES_PER_LINE, false);
+    xstring_printf(out, "};\nunsigned int %s_len = %zu;\n", name, size);
+}
+
+// same output as the base64 | tr -d '\r\n' pipeline used before
+void embed_base64_string(XUiString *out, const char *name, const unsigned char *data, size_t size) {
+    static const char b64[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+    xstring_printf(out, "const char* %s = \"", name);
+    char quad[4096];
+    size_t n = 0;
+    size_t i = 0;
+    for (;i+2<size;i+=3) {
+        uint32_t v = (data[i] << 16) | (data[i+1] << 8) | data[i+2];
+        quad[n++] = b64[(v >> 18) & 0x3f];
+        quad[n++] = b64[(v >> 12) & 0x3f];
+        quad[n++] = b64[(v >> 6) & 0x3f];
+        quad[n++] = b64[v & 0x3f];
+        if (n == sizeof(quad)) {
+            xstring_append_len(out, quad, n);
+            n = 0;
+        }
+    }
+    if (i < size) {
+        uint32_t v = data[i] << 16;
+        if (i + 1 < size) v |= data[i+1] << 8;
+        quad[n++] = b64[(v >> 18) & 0x3f];
+        quad[n++] = b64[(v >> 12) & 0x3f];
+        quad[n++] = i + 1 < size ? b64[(v >> 6) & 0x3f] : '=';
+        quad[n++] = '=';
+    }
+    xstring_append_len(out, quad, n);
+    xstring_append(out, "\";\n");
+}
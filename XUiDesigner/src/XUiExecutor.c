@@ -0,0 +1,311 @@
+/*
+ *                           0BSD 
+ * 
+ *                    BSD Zero Clause License
+ * 
+ *  Copyright (c) 2021 Hermann Meyer
+ *
+ * Permission to use, copy, modify, and/or distribute this software for any
+ * purpose with or without fee is hereby granted.
+
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES WITH
+ * REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY
+ * AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT,
+ * INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM
+ * LOSS OF USE, DATA OR PROFITS, WHETHER IN AN ACTION OF CONTRACT, NEGLIGENCE OR
+ * OTHER TORTIOUS ACTION, ARISING OUT OF OR IN CONNECTION WITH THE USE OR
+ * PERFORMANCE OF THIS SOFTWARE.
+ *
+ */
+
+
+#include <errno.h>
+#include <fcntl.h>
+
+#include "XUiExecutor.h"
+
+
+/*---------------------------------------------------------------------
+-----------------------------------------------------------------------    
+                worker threads reporting back to the UI thread
+-----------------------------------------------------------------------
+----------------------------------------------------------------------*/
+
+typedef enum {
+    JOB_PROGRESS,
+    JOB_DONE,
+} JobEventType;
+
+struct XUiJob {
+    XUiExecutor *ex;
+    job_func run;
+    job_done_func done;
+    job_progress_func progress;
+    void *data;
+    volatile bool cancelled;
+    bool finished;
+    XUiJob *next;
+};
+
+typedef struct JobEvent {
+    JobEventType type;
+    XUiJob *job;
+    int step;
+    int steps;
+    char *msg;
+    struct JobEvent *next;
+} JobEvent;
+
+struct XUiExecutor {
+    XUiScheduler *sched;
+    pthread_t *thread;
+    int threads;
+    pthread_mutex_t lock;
+    pthread_cond_t wake;
+    pthread_cond_t finished;
+    XUiJob *queue;
+    XUiJob *queue_tail;
+    JobEvent *event;
+    JobEvent *event_tail;
+    int pipe_fd[2];
+    bool quit;
+};
+
+static void post_event(XUiExecutor *ex, JobEventType type, XUiJob *job,
+                                    int step, int steps, const char *msg) {
+    JobEvent *ev = (JobEvent*)malloc(sizeof(JobEvent));
+    ev->type = type;
+    ev->job = job;
+    ev->step = step;
+    ev->steps = steps;
+    ev->msg = msg ? strdup(msg) : NULL;
+    ev->next = NULL;
+    pthread_mutex_lock(&ex->lock);
+    if (ex->event_tail) ex->event_tail->next = ev;
+    else ex->event = ev;
+    ex->event_tail = ev;
+    if (type == JOB_DONE) {
+        job->finished = true;
+        pthread_cond_broadcast(&ex->finished);
+    }
+    pthread_mutex_unlock(&ex->lock);
+    char c = 0;
+    if (write(ex->pipe_fd[1], &c, 1) < 0 && errno != EAGAIN)
+        fprintf(stderr, "executor: failed to wake the UI thread\n");
+}
+
+static void *worker(void *ex_) {
+    XUiExecutor *ex = (XUiExecutor*)ex_;
+    pthread_mutex_lock(&ex->lock);
+    while (true) {
+        while (!ex->queue && !ex->quit) pthread_cond_wait(&ex->wake, &ex->lock);
+        if (!ex->queue) break;
+        XUiJob *job = ex->queue;
+        ex->queue = job->next;
+        if (!ex->queue) ex->queue_tail = NULL;
+        pthread_mutex_unlock(&ex->lock);
+        if (!job->cancelled) job->run(job, job->data);
+        post_event(ex, JOB_DONE, job, 0, 0, NULL);
+        pthread_mutex_lock(&ex->lock);
+    }
+    pthread_mutex_unlock(&ex->lock);
+    return NULL;
+}
+
+// deliver progress and completion to the callbacks, always on the UI thread
+static void dispatch_events(XUiExecutor *ex) {
+    pthread_mutex_lock(&ex->lock);
+    JobEvent *ev = ex->event;
+    ex->event = ex->event_tail = NULL;
+    pthread_mutex_unlock(&ex->lock);
+    while (ev) {
+        JobEvent *next = ev->next;
+        XUiJob *job = ev->job;
+        if (ev->type == JOB_PROGRESS) {
+            if (job->progress && !job->cancelled)
+                job->progress(job, job->data, ev->step, ev->steps, ev->msg);
+        } else {
+            if (job->done) job->done(job, job->data);
+            free(job);
+        }
+        free(ev->msg);
+        free(ev);
+        ev = next;
+    }
+}
+
+static void executor_wakeup(int fd, void *data) {
+    char buf[64];
+    while (read(fd, buf, sizeof(buf)) > 0);
+    dispatch_events((XUiExecutor*)data);
+}
+
+XUiExecutor *executor_new(XUiScheduler *sched, int threads) {
+    XUiExecutor *ex = (XUiExecutor*)malloc(sizeof(XUiExecutor));
+    if (pipe(ex->pipe_fd) == -1) {
+        fprintf(stderr, "executor: could not create pipe\n");
+        free(ex);
+        return NULL;
+    }
+    fcntl(ex->pipe_fd[0], F_SETFL, O_NONBLOCK);
+    fcntl(ex->pipe_fd[1], F_SETFL, O_NONBLOCK);
+    ex->sched = sched;
+    ex->queue = ex->queue_tail = NULL;
+    ex->event = ex->event_tail = NULL;
+    ex->quit = false;
+    pthread_mutex_init(&ex->lock, NULL);
+    pthread_cond_init(&ex->wake, NULL);
+    pthread_cond_init(&ex->finished, NULL);
+    if (threads < 1) threads = min(8, max(2, (int)sysconf(_SC_NPROCESSORS_ONLN)));
+    ex->thread = (pthread_t*)malloc(threads * sizeof(pthread_t));
+    ex->threads = 0;
+    int i = 0;
+    for (;i<threads;i++) {
+        if (pthread_create(&ex->thread[ex->threads], NULL, worker, ex) == 0) ex->threads++;
+    }
+    scheduler_watch_fd(sched, ex->pipe_fd[0], executor_wakeup, ex);
+    return ex;
+}
+
+void executor_free(XUiExecutor *ex) {
+    if (!ex) return;
+    pthread_mutex_lock(&ex->lock);
+    XUiJob *job = ex->queue;
+    for (;job;job = job->next) job->cancelled = true;
+    ex->quit = true;
+    pthread_cond_broadcast(&ex->wake);
+    pthread_mutex_unlock(&ex->lock);
+    int i = 0;
+    for (;i<ex->threads;i++) {
+        pthread_join(ex->thread[i], NULL);
+    }
+    dispatch_events(ex);
+    scheduler_unwatch_fd(ex->sched, ex->pipe_fd[0]);
+    close(ex->pipe_fd[0]);
+    close(ex->pipe_fd[1]);
+    pthread_mutex_destroy(&ex->lock);
+    pthread_cond_destroy(&ex->wake);
+    pthread_cond_destroy(&ex->finished);
+    free(ex->thread);
+    free(ex);
+}
+
+XUiJob *executor_submit(XUiExecutor *ex, job_func run, job_done_func done,
+                                    job_progress_func progress, void *data) {
+    XUiJob *job = (XUiJob*)malloc(sizeof(XUiJob));
+    job->ex = ex;
+    job->run = run;
+    job->done = done;
+    job->progress = progress;
+    job->data = data;
+    job->cancelled = false;
+    job->finished = false;
+    job->next = NULL;
+    pthread_mutex_lock(&ex->lock);
+    if (ex->quit || !ex->threads) {
+        pthread_mutex_unlock(&ex->lock);
+        // no worker left, run it right here
+        run(job, data);
+        if (done) done(job, data);
+        free(job);
+        return NULL;
+    }
+    if (ex->queue_tail) ex->queue_tail->next = job;
+    else ex->queue = job;
+    ex->queue_tail = job;
+    pthread_cond_signal(&ex->wake);
+    pthread_mutex_unlock(&ex->lock);
+    return job;
+}
+
+void executor_wait(XUiExecutor *ex, XUiJob *job) {
+    pthread_mutex_lock(&ex->lock);
+    while (!job->finished) pthread_cond_wait(&ex->finished, &ex->lock);
+    pthread_mutex_unlock(&ex->lock);
+    dispatch_events(ex);
+}
+
+/*---------------------------------------------------------------------
+-----------------------------------------------------------------------    
+                fan out a batch of items and join
+-----------------------------------------------------------------------
+----------------------------------------------------------------------*/
+
+typedef struct {
+    parallel_func run;
+    void **item;
+    int count;
+    int next;
+    int pending;
+    int refs;
+    pthread_mutex_t lock;
+    pthread_cond_t done;
+} Batch;
+
+static bool batch_run_one(Batch *b) {
+    pthread_mutex_lock(&b->lock);
+    if (b->next >= b->count) {
+        pthread_mutex_unlock(&b->lock);
+        return false;
+    }
+    int i = b->next++;
+    pthread_mutex_unlock(&b->lock);
+    b->run(b->item[i]);
+    pthread_mutex_lock(&b->lock);
+    if (--b->pending == 0) pthread_cond_broadcast(&b->done);
+    pthread_mutex_unlock(&b->lock);
+    return true;
+}
+
+// helpers may start after the batch is joined, the last one to leave frees it
+static void batch_release(Batch *b) {
+    pthread_mutex_lock(&b->lock);
+    int refs = --b->refs;
+    pthread_mutex_unlock(&b->lock);
+    if (refs) return;
+    pthread_mutex_destroy(&b->lock);
+    pthread_cond_destroy(&b->done);
+    free(b);
+}
+
+static void batch_worker(XUiJob* UNUSED(job), void *data) {
+    Batch *b = (Batch*)data;
+    while (batch_run_one(b));
+    batch_release(b);
+}
+
+// the caller works on the batch too, so this is safe to call from a worker
+void executor_parallel(XUiExecutor *ex, parallel_func run, void **items, int count) {
+    if (count < 1) return;
+    Batch *b = (Batch*)malloc(sizeof(Batch));
+    b->run = run;
+    b->item = items;
+    b->count = count;
+    b->next = 0;
+    b->pending = count;
+    pthread_mutex_init(&b->lock, NULL);
+    pthread_cond_init(&b->done, NULL);
+    int helpers = min(count-1, ex->threads);
+    b->refs = helpers + 1;
+    int i = 0;
+    for (;i<helpers;i++) {
+        executor_submit(ex, batch_worker, NULL, NULL, b);
+    }
+    while (batch_run_one(b));
+    pthread_mutex_lock(&b->lock);
+    while (b->pending) pthread_cond_wait(&b->done, &b->lock);
+    pthread_mutex_unlock(&b->lock);
+    batch_release(b);
+}
+
+void job_cancel(XUiJob *job) {
+    job->cancelled = true;
+}
+
+bool job_is_cancelled(XUiJob *job) {
+    return job->cancelled;
+}
+
+void job_progress(XUiJob *job, int step, int steps, const char *msg) {
+    post_event(job->ex, JOB_PROGRESS, job, step, steps, msg);
+}
@@ -26,6 +26,8 @@
 #include "XUiTurtleView.h"
 #include "XUiWritePlugin.h"
 #include "XUiReadJson.h"
+#include "XUiExecutor.h"
+#include "XUiString.h"
 
 char *substr(const char *str, const char *p1, const char *p2) {
     const char *i1 = strstr(str, p1);
@@ -51,14 +53,24 @@ char *substr(const char *str, const char *p1, const char *p2) {
 -----------------------------------------------------------------------
 ----------------------------------------------------------------------*/
 
-static bool check_synth(XUiDesigner *designer, const char* filename) {
+// dsp2cc and faust2lv2 can take seconds, they run on a worker and the
+// designer gets set up from the result on the UI thread
+typedef struct {
+    XUiDesigner *designer;
+    char *filename;
+    char *outname;
+    char *voices;
+    bool is_synth;
+    int ret;
+    int status;
+    XUiString ports;
+} FaustParse;
+
+static bool check_synth(FaustParse *fp_) {
     bool is_synth = false;
-    char* cmd = NULL;
-    char * voices = NULL;
-    char* tmp = strdup(filename);
     char buf[128];
     FILE *fp;
-    if((fp = fopen(tmp, "r")) == NULL) {
+    if((fp = fopen(fp_->filename, "r")) == NULL) {
         printf("Error opening pipe!\n");
         return false;
     }
@@ -67,125 +79,126 @@ static bool check_synth(XUiDesigner *designer, const char* filename) {
             fprintf(stderr, "is synth\n");
             is_synth = true;
         } else if (strstr(buf, "[nvoices:") != NULL) {
-            voices = substr(buf, ":", "]");
-            fprintf(stderr, "is %s nvoices synth\n", voices); //declare options "[nvoices:6]";
+            fp_->voices = substr(buf, ":", "]");
+            fprintf(stderr, "is %s nvoices synth\n", fp_->voices); //declare options "[nvoices:6]";
             is_synth = true;
             break;
         }
     }
     if (fclose(fp)) {
         printf("Command not found or exited with error status\n");
-        free(voices);
+        free(fp_->voices);
+        fp_->voices = NULL;
         return false;
     }
     if (is_synth) {
-        if (voices == NULL) voices = strdup("8");
-        char *tmp2 = strdup(tmp);
-        char *b = basename(tmp2);
-        asprintf(&cmd, "cp %s /tmp/%s", tmp, b);
+        if (fp_->voices == NULL) fp_->voices = strdup("8");
+        char* cmd = NULL;
+        char *tmp = strdup(fp_->filename);
+        char *b = basename(tmp);
+        asprintf(&cmd, "cp %s /tmp/%s", fp_->filename, b);
         int ret = system(cmd);
         free(cmd);
         cmd = NULL;
-        asprintf(&cmd, "faust2lv2 -nvoices %s -keep /tmp/%s", voices, b);
+        asprintf(&cmd, "faust2lv2 -nvoices %s -keep /tmp/%s", fp_->voices, b);
         ret = system(cmd);
-        if (ret) {
-            open_message_dialog(designer->ui, ERROR_BOX, "",
-                "Fail to parse faust file", NULL);        
-            free(voices);
-            free(tmp);
-            return false;
-        }
-        if (designer->world) {
-            lilv_world_free(designer->world);
-            designer->world = NULL;
-        }
-        strdecode(b, ".dsp", ".cpp");
-        strdecode(tmp, ".dsp", "");
-        char *folder = basename(tmp);
-        free(designer->faust_synth_voices);
-        designer->faust_synth_voices = NULL;
-        asprintf(&designer->faust_synth_voices, "%s", voices);
-        free(designer->faust_synth_file);
-        designer->faust_synth_file = NULL;
-        asprintf(&designer->faust_synth_file, "/tmp/%s/%s", folder, b);
-        designer->is_faust_synth_file = true;
-
-        combobox_delete_entrys(designer->lv2_uris);
-        combobox_delete_entrys(designer->lv2_names);
-        combobox_add_entry(designer->lv2_uris,_("--"));
-        combobox_add_entry(designer->lv2_names,_("--"));
-        designer->world = lilv_world_new();
-        free(designer->path);
-        designer->path = NULL;
-        asprintf(&designer->path, "/tmp/%s", folder);
-        load_lv2_uris (designer);
-        combobox_set_active_entry(designer->lv2_uris, 1);
-        combobox_set_active_entry(designer->lv2_names, 1);
-
-        free(designer->lv2c.ui_uri);
-        designer->lv2c.ui_uri = NULL;
-        asprintf(&designer->lv2c.ui_uri, "urn:%s:%s%s", getUserName(), folder,"_ui");
-
-        free(voices);
-        voices = NULL;
         free(cmd);
-        cmd = NULL;
-        free(tmp2);
-        tmp2 = NULL;
+        free(tmp);
+        fp_->ret = ret;
     }
-    free(tmp);
     return is_synth;
 }
 
-void parse_faust_file (XUiDesigner *designer, const char* filename) {
-    if (check_synth(designer, filename)) return;
+static void faust_parse_run(XUiJob* UNUSED(job), void *data) {
+    FaustParse *fp_ = (FaustParse*)data;
+    fp_->is_synth = check_synth(fp_);
+    if (fp_->is_synth) return;
     char* cmd = NULL;
-    char* tmp = strdup(filename);
-    strdecode(tmp, ".dsp", ".cc");
-    char* outname = NULL;
-    asprintf(&outname, "/tmp/%s", basename(tmp));
-    free(tmp);
-    tmp = NULL;
-    tmp = strdup(filename);
-    free(designer->faust_path);
-    designer->faust_path = NULL;
-    asprintf(&designer->faust_path, "%s/",dirname(tmp));
-    free(tmp);
-    tmp = NULL;    
     if (access("./tools/dsp2cc", F_OK) == 0) {
-        asprintf(&cmd, "./tools/dsp2cc -d %s -b -o %s", filename, outname);
+        asprintf(&cmd, "./tools/dsp2cc -d %s -b -o %s", fp_->filename, fp_->outname);
     } else {
-        asprintf(&cmd, "dsp2cc -d %s -b -o %s", filename, outname);
-    }
-
-    int ret = system(cmd);
-    if (ret) {
-        open_message_dialog(designer->ui, ERROR_BOX, "",
-            "Fail to parse faust file", NULL);        
-        free(outname);
-        outname = NULL;
-        free(cmd);
-        cmd = NULL;
-        return;
+        asprintf(&cmd, "dsp2cc -d %s -b -o %s", fp_->filename, fp_->outname);
     }
-    free(designer->faust_file);
-    designer->faust_file = NULL;
-    asprintf(&designer->faust_file, "%s", outname);
+    fp_->ret = system(cmd);
     free(cmd);
     cmd = NULL;
+    if (fp_->ret) return;
     char buf[128];
     FILE *fp;
-    asprintf(&cmd, "cat %s | sed -n '/enum/,/PortIndex/p' |  sed '/enum/d;/PortIndex/d;/{/d;/}/d'", outname);
+    asprintf(&cmd, "cat %s | sed -n '/enum/,/PortIndex/p' |  sed '/enum/d;/PortIndex/d;/{/d;/}/d'", fp_->outname);
     if((fp = popen(cmd, "r")) == NULL) {
         printf("Error opening pipe!\n");
+        fp_->status = -1;
+        free(cmd);
         return;
     }
+    while (fgets(buf, 128, fp) != NULL) {
+        xstring_append(&fp_->ports, buf);
+    }
+    fp_->status = pclose(fp);
+    free(cmd);
+}
+
+static void faust_synth_loaded(XUiDesigner *designer, FaustParse *fp_) {
+    char* tmp = strdup(fp_->filename);
+    char *tmp2 = strdup(tmp);
+    char *b = basename(tmp2);
+    if (designer->world) {
+        lilv_world_free(designer->world);
+        designer->world = NULL;
+    }
+    strdecode(b, ".dsp", ".cpp");
+    strdecode(tmp, ".dsp", "");
+    char *folder = basename(tmp);
+    free(designer->faust_synth_voices);
+    designer->faust_synth_voices = NULL;
+    asprintf(&designer->faust_synth_voices, "%s", fp_->voices);
+    free(designer->faust_synth_file);
+    designer->faust_synth_file = NULL;
+    asprintf(&designer->faust_synth_file, "/tmp/%s/%s", folder, b);
+    designer->is_faust_synth_file = true;
+
+    combobox_delete_entrys(designer->lv2_uris);
+    combobox_delete_entrys(designer->lv2_names);
+    combobox_add_entry(designer->lv2_uris,_("--"));
+    combobox_add_entry(designer->lv2_names,_("--"));
+    free(designer->path);
+    designer->path = NULL;
+    asprintf(&designer->path, "/tmp/%s", folder);
+    load_lv2_uris (designer);
+    combobox_set_active_entry(designer->lv2_uris, 1);
+    combobox_set_active_entry(designer->lv2_names, 1);
+
+    free(designer->lv2c.ui_uri);
+    designer->lv2c.ui_uri = NULL;
+    asprintf(&designer->lv2c.ui_uri, "urn:%s:%s%s", getUserName(), folder,"_ui");
+
+    free(tmp2);
+    tmp2 = NULL;
+    free(tmp);
+}
+
+static void faust_ports_loaded(XUiDesigner *designer, FaustParse *fp_) {
+    char* tmp = strdup(fp_->filename);
+    free(designer->faust_path);
+    designer->faust_path = NULL;
+    asprintf(&designer->faust_path, "%s/",dirname(tmp));
+    free(tmp);
+    tmp = NULL;    
+    free(designer->faust_file);
+    designer->faust_file = NULL;
+    asprintf(&designer->faust_file, "%s", fp_->outname);
     int p = 1;
     int j = 0;
     designer->lv2c.audio_input = 0;
     designer->lv2c.audio_output = 0;
     designer->ui->flags |= FAST_REDRAW;
-    while (fgets(buf, 128, fp) != NULL) {
+    char *line = fp_->ports.str;
+    while (line && *line) {
+        char *end = strchr(line, '\n');
+        size_t len = end ? (size_t)(end - line) + 1 : strlen(line);
+        char *buf = strndup(line, len);
+        line += len;
         if (strstr(buf, "input") != NULL) {
             designer->lv2c.audio_input += 1;
             j++;
@@ -238,9 +251,10 @@ void parse_faust_file (XUiDesigner *designer, const char* filename) {
             free(label);
             label = NULL;
         }
+        free(buf);
         //printf("OUTPUT: %s", buf);
     }
-    if (pclose(fp)) {
+    if (fp_->status) {
         printf("Command not found or exited with error status\n");
         return;
     }
@@ -248,6 +262,7 @@ void parse_faust_file (XUiDesigner *designer, const char* filename) {
     designer->ui->height = 120;
     XResizeWindow(designer->ui->app->dpy, designer->ui->widget, designer->ui->width, designer->ui->height);
 
+    char *outname = strdup(fp_->outname);
     strdecode(outname, ".cc", "");
     widget_set_title(designer->ui,basename(outname));
     free(designer->lv2c.ui_uri);
@@ -257,23 +272,55 @@ void parse_faust_file (XUiDesigner *designer, const char* filename) {
     designer->lv2c.uri = NULL;
     asprintf(&designer->lv2c.uri, "urn:%s:%s", getUserName(), basename(outname));
     designer->is_faust_file = true;
-    free(cmd);
-    cmd = NULL;    
     free(outname);
     outname = NULL;
     if (!designer->ttlfile_view) create_text_view_window(designer);
-    XWindowAttributes attrs;
-    XGetWindowAttributes(designer->ttlfile_view->app->dpy, (Window)designer->ttlfile_view->widget, &attrs);
-    if (attrs.map_state == IsViewable) {
+    if (designer->ttlfile_view_mapped) {
         run_generate_ttl(designer->ttlfile, NULL);
     }
-    pthread_t rf;
-    pthread_create(&rf, NULL, reset_flag, (void *)designer);
+    reset_fast_redraw(designer);
     //print_ttl(designer);
     //print_plugin(designer);
     //print_makefile(designer);
 }
 
+static void faust_parse_done(XUiJob *job, void *data) {
+    FaustParse *fp_ = (FaustParse*)data;
+    XUiDesigner *designer = fp_->designer;
+    if (!job_is_cancelled(job)) {
+        if (fp_->ret) {
+            open_message_dialog(designer->ui, ERROR_BOX, "",
+                "Fail to parse faust file", NULL);        
+        } else if (fp_->is_synth) {
+            faust_synth_loaded(designer, fp_);
+        } else {
+            faust_ports_loaded(designer, fp_);
+        }
+    }
+    xstring_free(&fp_->ports);
+    free(fp_->filename);
+    free(fp_->outname);
+    free(fp_->voices);
+    free(fp_);
+}
+
+void parse_faust_file (XUiDesigner *designer, const char* filename) {
+    FaustParse *fp_ = (FaustParse*)malloc(sizeof(FaustParse));
+    fp_->designer = designer;
+    fp_->filename = strdup(filename);
+    char* tmp = strdup(filename);
+    strdecode(tmp, ".dsp", ".cc");
+    fp_->outname = NULL;
+    asprintf(&fp_->outname, "/tmp/%s", basename(tmp));
+    free(tmp);
+    fp_->voices = NULL;
+    fp_->is_synth = false;
+    fp_->ret = 0;
+    fp_->status = 0;
+    xstring_init(&fp_->ports);
+    executor_submit(designer->executor, faust_parse_run, faust_parse_done, NULL, fp_);
+}
+
 static void parse_c_file (XUiDesigner *designer, char* filename) {
     char* cmd = NULL;
     char* outname = strdup(filename);
@@ -369,13 +416,10 @@ static void parse_c_file (XUiDesigner *designer, char* filename) {
     free(outname);
     outname = NULL;
     if (!designer->ttlfile_view) create_text_view_window(designer);
-    XWindowAttributes attrs;
-    XGetWindowAttributes(designer->ttlfile_view->app->dpy, (Window)designer->ttlfile_view->widget, &attrs);
-    if (attrs.map_state == IsViewable) {
+    if (designer->ttlfile_view_mapped) {
         run_generate_ttl(designer->ttlfile, NULL);
     }
-    pthread_t rf;
-    pthread_create(&rf, NULL, reset_flag, (void *)designer);
+    reset_fast_redraw(designer);
     //print_ttl(designer);
     //print_plugin(designer);
     //print_makefile(designer);
@@ -0,0 +1,124 @@
+/*
+ *                           0BSD 
+ * 
+ *                    BSD Zero Clause License
+ * 
+ *  Copyright (c) 2021 Hermann Meyer
+ *
+ * Permission to use, copy, modify, and/or distribute this software for any
+ * purpose with or without fee is hereby granted.
+
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES WITH
+ * REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY
+ * AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT,
+ * INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM
+ * LOSS OF USE, DATA OR PROFITS, WHETHER IN AN ACTION OF CONTRACT, NEGLIGENCE OR
+ * OTHER TORTIOUS ACTION, ARISING OUT OF OR IN CONNECTION WITH THE USE OR
+ * PERFORMANCE OF THIS SOFTWARE.
+ *
+ */
+
+
+#include <sys/stat.h>
+#include <dirent.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+#include "XUiFiles.h"
+
+
+/*---------------------------------------------------------------------
+-----------------------------------------------------------------------    
+            copy and remove files in process instead of cp and rm
+-----------------------------------------------------------------------
+----------------------------------------------------------------------*/
+
+// keeps the mode of the source, an existing copy with the same size and mtime is left alone
+int files_copy(const char *source, const char *dest) {
+    struct stat src;
+    struct stat dst;
+    if (stat(source, &src) == -1) return -1;
+    if (stat(dest, &dst) == 0 && dst.st_size == src.st_size && dst.st_mtime >= src.st_mtime) return 0;
+    int in = open(source, O_RDONLY);
+    if (in == -1) return -1;
+    int out = open(dest, O_WRONLY | O_CREAT | O_TRUNC, src.st_mode & 0777);
+    if (out == -1) {
+        close(in);
+        return -1;
+    }
+    char buf[65536];
+    int ret = 0;
+    ssize_t got = 0;
+    while ((got = read(in, buf, sizeof(buf))) > 0) {
+        char *p = buf;
+        while (got > 0) {
+            ssize_t put = write(out, p, got);
+            if (put < 0) {
+                if (errno == EINTR) continue;
+                ret = -1;
+                break;
+            }
+            p += put;
+            got -= put;
+        }
+        if (ret) break;
+    }
+    if (got < 0) ret = -1;
+    close(in);
+    if (close(out) == -1) ret = -1;
+    return ret;
+}
+
+// a vendored checkout doesn't need the history, .git is skipped
+int files_copy_tree(const char *source, const char *dest) {
+    struct stat st;
+    if (lstat(source, &st) == -1) return -1;
+    if (S_ISLNK(st.st_mode)) {
+        char link[PATH_MAX];
+        ssize_t len = readlink(source, link, sizeof(link)-1);
+        if (len < 0) return -1;
+        link[len] = '\0';
+        unlink(dest);
+        return symlink(link, dest);
+    }
+    if (!S_ISDIR(st.st_mode)) return files_copy(source, dest);
+    if (mkdir(dest, st.st_mode & 0777) == -1 && errno != EEXIST) return -1;
+    DIR *dir = opendir(source);
+    if (dir == NULL) return -1;
+    int ret = 0;
+    struct dirent *entry;
+    while (!ret && (entry = readdir(dir)) != NULL) {
+        if (strcmp(entry->d_name, ".") == 0 || strcmp(entry->d_name, "..") == 0 ||
+                strcmp(entry->d_name, ".git") == 0) continue;
+        char *from = NULL;
+        char *to = NULL;
+        asprintf(&from, "%s/%s", source, entry->d_name);
+        asprintf(&to, "%s/%s", dest, entry->d_name);
+        ret = files_copy_tree(from, to);
+        free(from);
+        free(to);
+    }
+    closedir(dir);
+    return ret;
+}
+
+// like rm -rf, a missing path is fine
+int files_remove_tree(const char *path) {
+    struct stat st;
+    if (lstat(path, &st) == -1) return errno == ENOENT ? 0 : -1;
+    if (!S_ISDIR(st.st_mode)) return unlink(path);
+    DIR *dir = opendir(path);
+    if (dir == NULL) return -1;
+    int ret = 0;
+    struct dirent *entry;
+    while (!ret && (entry = readdir(dir)) != NULL) {
+        if (strcmp(entry->d_name, ".") == 0 || strcmp(entry->d_name, "..") == 0) continue;
+        char *child = NULL;
+        asprintf(&child, "%s/%s", path, entry->d_name);
+        ret = files_remove_tree(child);
+        free(child);
+    }
+    closedir(dir);
+    return ret ? ret : rmdir(path);
+}
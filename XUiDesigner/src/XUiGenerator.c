@@ -19,7 +19,10 @@
  */
 
 #include <stdio.h>
+#include <stdarg.h>
+#include <time.h>
 #include <sys/stat.h>
+#include <dirent.h>
 #include <unistd.h>
 #include <libgen.h>
 #include <ctype.h>
@@ -30,6 +33,14 @@
 #include "XUiWritePlugin.h"
 #include "XUiWriteUI.h"
 #include "XUiWriteJson.h"
+#include "XUiImageLoader.h"
+#include "XUiTurtleView.h"
+#include "XUiScheduler.h"
+#include "XUiExecutor.h"
+#include "XUiEmbed.h"
+#include "XUiAtlas.h"
+#include "XUiFiles.h"
+#include "XUiLivePreview.h"
 
 
 /*---------------------------------------------------------------------
@@ -39,6 +50,7 @@
 ----------------------------------------------------------------------*/
 
 void remove_from_list(XUiDesigner *designer, Widget_t *wid) {
+    sprite_frames_free(designer, wid);
     designer->controls[wid->data].wid = NULL;
     designer->controls[wid->data].have_adjustment = false;
     free(designer->controls[wid->data].image);
@@ -51,6 +63,7 @@ void remove_from_list(XUiDesigner *designer, Widget_t *wid) {
     designer->controls[wid->data].is_audio_output = false;
     designer->controls[wid->data].is_atom_input = false;
     designer->controls[wid->data].is_atom_output = false;
+    designer_changed(designer);
 }
 
 void add_to_list(XUiDesigner *designer, Widget_t *wid, const char* type,
@@ -59,6 +72,7 @@ void add_to_list(XUiDesigner *designer, Widget_t *wid, const char* type,
     designer->controls[wid->data].type = type;
     designer->controls[wid->data].have_adjustment = have_adjustment;
     designer->controls[wid->data].is_type = is_type;
+    designer_changed(designer);
     //show_list(designer);
 }
 
@@ -129,13 +143,91 @@ void strtoguard(char* c) {
     }
 }
 
+/*---------------------------------------------------------------------
+-----------------------------------------------------------------------    
+            find project images with the same content
+-----------------------------------------------------------------------
+----------------------------------------------------------------------*/
+
+void free_shared_images(XUiDesigner *designer) {
+    int i = 0;
+    for (;i<designer->shared_images;i++) {
+        free(designer->shared_image[i].image);
+    }
+    free(designer->shared_image);
+    designer->shared_image = NULL;
+    designer->shared_images = 0;
+}
+
+static void add_shared_image(XUiDesigner *designer, const char *image,
+                                uint64_t *hash, size_t *size) {
+    int i = 0;
+    for (;i<designer->shared_images;i++) {
+        if (strcmp(designer->shared_image[i].image, image) == 0) return;
+    }
+    unsigned char *data = NULL;
+    size_t len = 0;
+    int n = designer->shared_images;
+    designer->shared_image = (SharedImage*)realloc(designer->shared_image, (n+1) * sizeof(SharedImage));
+    designer->shared_image[n].image = strdup(image);
+    designer->shared_image[n].same = n;
+    designer->shared_images++;
+    // unreadable images stay on their own, the save reports them
+    if (embed_read_file(image, &data, &len)) {
+        hash[n] = 0;
+        size[n] = 0;
+        return;
+    }
+    hash[n] = hash_data((const char*)data, len);
+    size[n] = len;
+    for (i=0;i<n;i++) {
+        if (size[i] != len || hash[i] != hash[n] || !size[i]) continue;
+        // a matching hash only makes it likely, compare the bytes before sharing
+        unsigned char *other = NULL;
+        size_t other_len = 0;
+        if (embed_read_file(designer->shared_image[i].image, &other, &other_len)) continue;
+        bool same = other_len == len && memcmp(other, data, len) == 0;
+        free(other);
+        if (same) {
+            designer->shared_image[n].same = designer->shared_image[i].same;
+            break;
+        }
+    }
+    free(data);
+}
+
+// hash every image once before a save, the generators then refer to one file per content
+void collect_shared_images(XUiDesigner *designer) {
+    free_shared_images(designer);
+    uint64_t hash[MAX_CONTROLS + 1];
+    size_t size[MAX_CONTROLS + 1];
+    if (designer->image != NULL) add_shared_image(designer, designer->image, hash, size);
+    int i = 0;
+    for (;i<MAX_CONTROLS;i++) {
+        if (designer->controls[i].wid != NULL && designer->controls[i].image != NULL) {
+            add_shared_image(designer, designer->controls[i].image, hash, size);
+        }
+    }
+}
+
+// the image the bundle holds for this one, images unknown to the last save stand for themselves
+const char *shared_image(XUiDesigner *designer, const char *image) {
+    int i = 0;
+    for (;i<designer->shared_images;i++) {
+        if (strcmp(designer->shared_image[i].image, image) == 0) {
+            return designer->shared_image[designer->shared_image[i].same].image;
+        }
+    }
+    return image;
+}
+
 /*---------------------------------------------------------------------
 -----------------------------------------------------------------------    
             generate a LV2 bunlde containing all needed files
 -----------------------------------------------------------------------
 ----------------------------------------------------------------------*/
 
-void print_makefile(XUiDesigner *designer) {
+void print_makefile(XUiDesigner *designer, XUiString *out) {
     char *name = NULL;
     XFetchName(designer->ui->app->dpy, designer->ui->widget, &name);
     if (name == NULL) asprintf(&name, "%s", "noname");
@@ -384,8 +476,8 @@ void print_makefile(XUiDesigner *designer) {
                 use_atom ? "-DUSE_ATOM" : "", use_midi ? "-DUSE_MIDI" : "",
                 use_atom ? "-DUSE_ATOM" : "", use_midi ? "-DUSE_MIDI" : "");
     }
-    printf("%s",cmd);
-    printf("%s",cmd2);
+    xstring_printf(out, "%s",cmd);
+    xstring_printf(out, "%s",cmd2);
     free(cmd);
     cmd = NULL;
     free(cmd2);
@@ -394,10 +486,607 @@ void print_makefile(XUiDesigner *designer) {
     name = NULL;
 }
 
+/*---------------------------------------------------------------------
+-----------------------------------------------------------------------    
+            run a generator into a memory buffer
+-----------------------------------------------------------------------
+----------------------------------------------------------------------*/
+
+char *generate_text(XUiDesigner *designer, generate_func generate, size_t *size) {
+    XUiString out;
+    xstring_init(&out);
+    generate(designer, &out);
+    return xstring_steal(&out, size);
+}
+
+/*---------------------------------------------------------------------
+-----------------------------------------------------------------------    
+        save a snapshot of the project on a worker thread
+-----------------------------------------------------------------------
+----------------------------------------------------------------------*/
+
+typedef enum {
+    SAVE_MKDIR,
+    SAVE_WRITE,
+    SAVE_SHELL,
+    SAVE_EMBED,
+    SAVE_ATLAS,
+    SAVE_COPY,
+    SAVE_REMOVE,
+    SAVE_TREE,
+} SaveStepType;
+
+typedef struct {
+    SaveStepType type;
+    char *path;
+    const char *label;
+    char *text;
+    size_t size;
+    generate_func generate;
+    char *json_path;
+    char *source;
+    char *copy;
+    char *var;
+    bool base64;
+    uint64_t copy_hash;
+    int page;
+    bool need_prev;
+    bool parallel;
+    bool skipped;
+    bool unchanged;
+    uint64_t hash;
+    int ret;
+} SaveStep;
+
+// content hash of a generated file, path relative to the bundle
+typedef struct {
+    uint64_t hash;
+    char *file;
+} HashEntry;
+
+#define HASH_FILE ".xuidesigner.hash"
+
+typedef struct {
+    XUiDesigner *designer;
+    XUiExecutor *ex;
+    char *bundle;
+    SaveStep *step;
+    int steps;
+    HashEntry *hash;
+    int hashes;
+    XUiAtlas atlas;
+    int done;
+    int failed;
+    bool parallel;
+    double time;
+} SaveJob;
+
+typedef struct {
+    XUiJob *job;
+    SaveJob *sj;
+    int first;
+    int last;
+} SaveChain;
+
+typedef struct {
+    XUiDesigner *designer;
+    SaveStep *step;
+} SaveGenerate;
+
+static char status_text[128];
+
+static double save_clock() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+// need_prev: skip the step when the one before failed or was skipped
+// steps added while sj->parallel is set may run side by side with each other
+static SaveStep *save_add_step(SaveJob *sj, SaveStepType type, bool need_prev,
+                                        const char *fmt, va_list args) {
+    sj->step = (SaveStep*)realloc(sj->step, (sj->steps+1) * sizeof(SaveStep));
+    SaveStep *s = &sj->step[sj->steps++];
+    s->type = type;
+    s->path = NULL;
+    vasprintf(&s->path, fmt, args);
+    const char *base = strrchr(s->path, '/');
+    s->label = base ? base+1 : s->path;
+    s->text = NULL;
+    s->size = 0;
+    s->generate = NULL;
+    s->json_path = NULL;
+    s->source = NULL;
+    s->copy = NULL;
+    s->var = NULL;
+    s->base64 = false;
+    s->copy_hash = 0;
+    s->page = 0;
+    s->need_prev = need_prev;
+    s->parallel = sj->parallel;
+    s->skipped = false;
+    s->unchanged = false;
+    s->hash = 0;
+    s->ret = 0;
+    return s;
+}
+
+static void save_mkdir(SaveJob *sj, const char *fmt, ...) {
+    va_list args;
+    va_start(args, fmt);
+    save_add_step(sj, SAVE_MKDIR, false, fmt, args);
+    va_end(args);
+}
+
+static void save_shell(SaveJob *sj, bool need_prev, const char *label, const char *fmt, ...) {
+    va_list args;
+    va_start(args, fmt);
+    SaveStep *s = save_add_step(sj, SAVE_SHELL, need_prev, fmt, args);
+    va_end(args);
+    s->label = label;
+}
+
+// the job takes over the text
+static void save_text(SaveJob *sj, char *text, size_t size, bool need_prev, const char *fmt, ...) {
+    va_list args;
+    va_start(args, fmt);
+    SaveStep *s = save_add_step(sj, SAVE_WRITE, need_prev, fmt, args);
+    va_end(args);
+    s->text = text;
+    s->size = size;
+}
+
+// the text gets generated by generate_save_files()
+static void save_file(SaveJob *sj, generate_func generate, bool need_prev, const char *fmt, ...) {
+    va_list args;
+    va_start(args, fmt);
+    SaveStep *s = save_add_step(sj, SAVE_WRITE, need_prev, fmt, args);
+    va_end(args);
+    s->generate = generate;
+}
+
+static void save_json(SaveJob *sj, const char *filepath, const char *fmt, ...) {
+    va_list args;
+    va_start(args, fmt);
+    SaveStep *s = save_add_step(sj, SAVE_WRITE, false, fmt, args);
+    va_end(args);
+    s->json_path = strdup(filepath);
+}
+
+// copy the image into the bundle and write it as C source, path is the source file
+static void save_embed(SaveJob *sj, const char *image, const char *copy, const char *var,
+                                        bool base64, const char *fmt, ...) {
+    va_list args;
+    va_start(args, fmt);
+    SaveStep *s = save_add_step(sj, SAVE_EMBED, false, fmt, args);
+    va_end(args);
+    s->source = strdup(image);
+    s->copy = strdup(copy);
+    s->var = strdup(var);
+    s->base64 = base64;
+}
+
+// copy a file into the bundle, path is the destination
+static void save_copy(SaveJob *sj, const char *source, bool need_prev, const char *fmt, ...) {
+    va_list args;
+    va_start(args, fmt);
+    SaveStep *s = save_add_step(sj, SAVE_COPY, need_prev, fmt, args);
+    va_end(args);
+    s->source = strdup(source);
+    s->label = "copy";
+}
+
+static void save_remove(SaveJob *sj, const char *fmt, ...) {
+    va_list args;
+    va_start(args, fmt);
+    SaveStep *s = save_add_step(sj, SAVE_REMOVE, false, fmt, args);
+    va_end(args);
+    s->label = "remove";
+}
+
+static void save_tree(SaveJob *sj, const char *source, const char *fmt, ...) {
+    va_list args;
+    va_start(args, fmt);
+    SaveStep *s = save_add_step(sj, SAVE_TREE, false, fmt, args);
+    va_end(args);
+    s->source = strdup(source);
+}
+
+// decode and pack the pngs now, the generated UI wraps the premultiplied pixels as they are
+static void save_atlas(SaveJob *sj, int page, const char *fmt, ...) {
+    va_list args;
+    va_start(args, fmt);
+    SaveStep *s = save_add_step(sj, SAVE_ATLAS, false, fmt, args);
+    va_end(args);
+    s->page = page;
+    asprintf(&s->var, "xui_atlas%i", page);
+}
+
+static void generate_save_file(void *data) {
+    SaveGenerate *g = (SaveGenerate*)data;
+    SaveStep *s = g->step;
+    XUiString out;
+    xstring_init(&out);
+    if (s->json_path) print_json(g->designer, s->json_path, &out);
+    else s->generate(g->designer, &out);
+    s->text = xstring_steal(&out, &s->size);
+}
+
+// print_ttl() writes the symbols sanitized, store them that way before the
+// generators read them side by side, so the json carries the same symbols
+static void sanitize_symbols(XUiDesigner *designer) {
+    int i = 0;
+    for (;i<MAX_CONTROLS;i++) {
+        if (designer->controls[i].wid != NULL && designer->controls[i].symbol &&
+                !designer->controls[i].is_atom_patch) {
+            strtosym(designer->controls[i].symbol);
+        }
+    }
+}
+
+// the generators only read the project, run them side by side while the UI waits
+static void generate_save_files(SaveJob *sj, XUiDesigner *designer) {
+    sanitize_symbols(designer);
+    SaveGenerate *task = (SaveGenerate*)malloc(sj->steps * sizeof(SaveGenerate));
+    void **items = (void**)malloc(sj->steps * sizeof(void*));
+    int count = 0;
+    int i = 0;
+    for (;i<sj->steps;i++) {
+        if (sj->step[i].generate || sj->step[i].json_path) {
+            task[count].designer = designer;
+            task[count].step = &sj->step[i];
+            items[count] = &task[count];
+            count++;
+        }
+    }
+    executor_parallel(sj->ex, generate_save_file, items, count);
+    free(items);
+    free(task);
+}
+
+static void save_image(SaveJob *sj, const char *image, const char *filepath) {
+    char* tmp = strdup(image);
+    char* xldl = strdup(basename(tmp));
+    free(tmp);
+    tmp = NULL;
+    strdecode(xldl, "-", "_");
+    strdecode(xldl, " ", "_");
+    strtovar(xldl);
+    if (strstr(image, ".png")) {
+        strdecode(xldl, "_png", ".png");
+        char* fxldl = NULL;
+        asprintf(&fxldl, "%s/%s", filepath, xldl);
+        if (strcmp(image,fxldl)) {
+            char* xldc = strdup(xldl);
+            strdecode(xldc, ".png", ".c");
+            // xxd -i names the array after the file
+            char* var = strdup(xldl);
+            strtosym(var);
+            save_embed(sj, image, fxldl, var, false, "%s/%s", filepath, xldc);
+            free(var);
+            free(xldc);
+        }
+        free(fxldl);
+    } else if (strstr(image, ".svg")) {
+        char* xldv = strdup(xldl);
+        strdecode(xldl, "_svg", ".svg");
+        char* fxldl = NULL;
+        asprintf(&fxldl, "%s/%s", filepath, xldl);
+        if (strcmp(image,fxldl)) {
+            char* xldc = strdup(xldl);
+            strdecode(xldc, ".svg", ".c");
+            save_embed(sj, image, fxldl, xldv, true, "%s/%s", filepath, xldc);
+            free(xldc);
+        }
+        free(fxldl);
+        free(xldv);
+    }
+    free(xldl);
+}
+
+static const char *file_name(const char *path) {
+    const char *base = strrchr(path, '/');
+    return base ? base+1 : path;
+}
+
+// a libxputty checkout on this machine, for the mirror and vendor setups
+static const char *libxputty_source(XUiDesigner *designer) {
+    if (designer->libxputty_path) return designer->libxputty_path;
+    if (access("./libxputty/libxputty", F_OK) == 0) return "./libxputty";
+    if (access("../libxputty/libxputty", F_OK) == 0) return "../libxputty";
+    return NULL;
+}
+
+// only the plain submodule setup needs the network
+static void save_repository(SaveJob *sj, XUiDesigner *designer, const char *filepath) {
+    char *libxputty = NULL;
+    asprintf(&libxputty, "%s/libxputty", filepath);
+    struct stat sb;
+    bool have_libxputty = stat(libxputty, &sb) == 0 && S_ISDIR(sb.st_mode);
+    char source[PATH_MAX];
+    const char *local = libxputty_source(designer);
+    bool have_local = local != NULL && realpath(local, source) != NULL;
+    switch (designer->repo_setup) {
+        case REPO_SUBMODULE:
+            save_shell(sj, false, "git init", "cd %s && git init", filepath);
+            if (!have_libxputty) {
+                save_shell(sj, false, "git submodule add",
+                    "cd %s && git submodule add https://github.com/brummer10/libxputty.git", filepath);
+            }
+        break;
+        case REPO_MIRROR:
+            save_shell(sj, false, "git init", "cd %s && git init", filepath);
+            if (!have_libxputty && have_local) {
+                // git refuses local submodule clones unless the file transport is allowed
+                save_shell(sj, false, "git submodule add",
+                    "cd %s && git -c protocol.file.allow=always submodule add \'%s\' libxputty",
+                                                                    filepath, source);
+            } else if (!have_libxputty) {
+                fprintf(stderr, "save: no local libxputty mirror found\n");
+            }
+        break;
+        case REPO_VENDOR:
+            if (have_local) save_tree(sj, source, "%s", libxputty);
+            else fprintf(stderr, "save: no local libxputty found to copy\n");
+        break;
+        case REPO_SKIP:
+        break;
+    }
+    free(libxputty);
+}
+
+static const char *bundle_file(SaveJob *sj, const char *path) {
+    size_t len = strlen(sj->bundle);
+    if (strncmp(path, sj->bundle, len) == 0 && path[len] == '/') return path + len + 1;
+    return path;
+}
+
+static HashEntry *find_hash(SaveJob *sj, const char *file) {
+    int i = 0;
+    for (;i<sj->hashes;i++) {
+        if (strcmp(sj->hash[i].file, file) == 0) return &sj->hash[i];
+    }
+    return NULL;
+}
+
+static void set_hash(SaveJob *sj, const char *file, uint64_t hash) {
+    HashEntry *e = find_hash(sj, file);
+    if (e == NULL) {
+        sj->hash = (HashEntry*)realloc(sj->hash, (sj->hashes+1) * sizeof(HashEntry));
+        e = &sj->hash[sj->hashes++];
+        e->file = strdup(file);
+    }
+    e->hash = hash;
+}
+
+static void read_hashes(SaveJob *sj) {
+    char *name = NULL;
+    asprintf(&name, "%s/" HASH_FILE, sj->bundle);
+    FILE *fp = fopen(name, "r");
+    free(name);
+    if (fp == NULL) return;
+    char buf[PATH_MAX + 32];
+    char file[PATH_MAX];
+    unsigned long long hash = 0;
+    while (fgets(buf, sizeof(buf), fp) != NULL) {
+        if (sscanf(buf, "%llx %[^\n]", &hash, file) == 2) set_hash(sj, file, hash);
+    }
+    fclose(fp);
+}
+
+// files from earlier saves stay in the list, a regenerate only touches some of them
+static void write_hashes(SaveJob *sj) {
+    int i = 0;
+    for (;i<sj->steps;i++) {
+        SaveStep *s = &sj->step[i];
+        if ((s->type == SAVE_WRITE || s->type == SAVE_EMBED || s->type == SAVE_ATLAS ||
+                                    s->type == SAVE_COPY) && !s->ret)
+            set_hash(sj, bundle_file(sj, s->path), s->hash);
+        if (s->type == SAVE_EMBED && !s->ret) set_hash(sj, bundle_file(sj, s->copy), s->copy_hash);
+    }
+    XUiString out;
+    xstring_init(&out);
+    for (i=0;i<sj->hashes;i++) {
+        xstring_printf(&out, "%016llx %s\n", (unsigned long long)sj->hash[i].hash, sj->hash[i].file);
+    }
+    char *name = NULL;
+    asprintf(&name, "%s/" HASH_FILE, sj->bundle);
+    if (xstring_write_file(&out, name)) fprintf(stderr, "save: could not write %s\n", name);
+    free(name);
+    xstring_free(&out);
+}
+
+static int write_hashed(SaveJob *sj, const char *path, const char *text, size_t size,
+                                        uint64_t *hash, bool *unchanged) {
+    *hash = hash_data(text, size);
+    // same content as last time, leave the file and its mtime alone
+    HashEntry *e = find_hash(sj, bundle_file(sj, path));
+    struct stat st;
+    if (e && e->hash == *hash && stat(path, &st) == 0 && (size_t)st.st_size == size) {
+        *unchanged = true;
+        return 0;
+    }
+    FILE *fp = fopen(path, "w");
+    if (fp == NULL) return -1;
+    size_t written = size ? fwrite(text, 1, size, fp) : 0;
+    int ret = fclose(fp);
+    return (written == size && !ret) ? 0 : -1;
+}
+
+static int run_save_step(SaveJob *sj, SaveStep *s) {
+    switch (s->type) {
+        case SAVE_MKDIR:
+        {
+            struct stat st = {0};
+            if (stat(s->path, &st) == -1) return mkdir(s->path, 0700);
+            return 0;
+        }
+        case SAVE_WRITE:
+        {
+            if (s->text == NULL) return -1;
+            return write_hashed(sj, s->path, s->text, s->size, &s->hash, &s->unchanged);
+        }
+        case SAVE_SHELL:
+            return system(s->path);
+        case SAVE_EMBED:
+        {
+            // read the image once, the copy and the C source come from the same buffer
+            unsigned char *data = NULL;
+            size_t size = 0;
+            if (embed_read_file(s->source, &data, &size)) return -1;
+            bool copy_unchanged = false;
+            int ret = write_hashed(sj, s->copy, (const char*)data, size, &s->copy_hash, &copy_unchanged);
+            if (!ret) {
+                XUiString out;
+                xstring_init(&out);
+                if (s->base64) embed_base64_string(&out, s->var, data, size);
+                else embed_c_array(&out, s->var, data, size);
+                ret = write_hashed(sj, s->path, out.str, out.len, &s->hash, &s->unchanged);
+                s->unchanged = s->unchanged && copy_unchanged;
+                xstring_free(&out);
+            }
+            free(data);
+            return ret;
+        }
+        case SAVE_ATLAS:
+        {
+            XUiString out;
+            xstring_init(&out);
+            int ret = atlas_compose(&sj->atlas, s->page, s->var, &out);
+            if (!ret) ret = write_hashed(sj, s->path, out.str, out.len, &s->hash, &s->unchanged);
+            xstring_free(&out);
+            return ret;
+        }
+        case SAVE_COPY:
+        {
+            unsigned char *data = NULL;
+            size_t size = 0;
+            if (embed_read_file(s->source, &data, &size)) return -1;
+            int ret = write_hashed(sj, s->path, (const char*)data, size, &s->hash, &s->unchanged);
+            free(data);
+            return ret;
+        }
+        case SAVE_REMOVE:
+            return files_remove_tree(s->path);
+        case SAVE_TREE:
+            return files_copy_tree(s->source, s->path);
+    }
+    return -1;
+}
+
+static void run_save_chain(void *data) {
+    SaveChain *c = (SaveChain*)data;
+    SaveJob *sj = c->sj;
+    int i = c->first;
+    for (;i<c->last;i++) {
+        SaveStep *s = &sj->step[i];
+        char *msg = NULL;
+        if (s->need_prev && i > 0 && sj->step[i-1].ret) {
+            s->ret = sj->step[i-1].ret;
+            s->skipped = true;
+            asprintf(&msg, "%s skipped", s->label);
+        } else {
+            double t = save_clock();
+            s->ret = run_save_step(sj, s);
+            if (s->unchanged) asprintf(&msg, "%s unchanged", s->label);
+            else asprintf(&msg, s->ret ? "%s failed %.2fs" : "%s %.2fs", s->label, save_clock() - t);
+        }
+        job_progress(c->job, __sync_add_and_fetch(&sj->done, 1), sj->steps, msg);
+        free(msg);
+    }
+}
+
+// runs on a worker thread, touches only the snapshot
+static void save_bundle(XUiJob *job, void *data) {
+    SaveJob *sj = (SaveJob*)data;
+    double start = save_clock();
+    read_hashes(sj);
+    SaveChain *chain = (SaveChain*)malloc(sj->steps * sizeof(SaveChain));
+    void **items = (void**)malloc(sj->steps * sizeof(void*));
+    int i = 0;
+    while (i<sj->steps) {
+        int chains = 0;
+        do {
+            // a step that needs the one before stays in the same chain
+            SaveChain *c = &chain[chains];
+            c->job = job;
+            c->sj = sj;
+            c->first = i++;
+            while (i<sj->steps && sj->step[i].need_prev && sj->step[i].parallel == sj->step[c->first].parallel) i++;
+            c->last = i;
+            items[chains] = c;
+            chains++;
+        } while (sj->step[chain[0].first].parallel && i<sj->steps && sj->step[i].parallel);
+        // sequential steps are barriers, the chains in between run side by side
+        if (chains > 1) executor_parallel(sj->ex, run_save_chain, items, chains);
+        else run_save_chain(items[0]);
+    }
+    free(items);
+    free(chain);
+    for (i=0;i<sj->steps;i++) {
+        if (sj->step[i].ret && !sj->step[i].skipped) sj->failed++;
+    }
+    write_hashes(sj);
+    sj->time = save_clock() - start;
+}
+
+static void show_save_status(XUiDesigner *designer) {
+    designer->save_status->label = status_text;
+    scheduler_queue_redraw(designer->scheduler, designer->save_status);
+}
+
+static void clear_save_status(void *data) {
+    XUiDesigner *designer = (XUiDesigner*)data;
+    status_text[0] = '\0';
+    show_save_status(designer);
+}
+
+static void save_progress(XUiJob* UNUSED(job), void *data, int step, int steps, const char *msg) {
+    SaveJob *sj = (SaveJob*)data;
+    snprintf(status_text, sizeof(status_text), "%i/%i %s", step, steps, msg);
+    show_save_status(sj->designer);
+}
+
+static void save_finished(XUiJob* UNUSED(job), void *data) {
+    SaveJob *sj = (SaveJob*)data;
+    XUiDesigner *designer = sj->designer;
+    designer->save_job = NULL;
+    if (sj->failed) {
+        snprintf(status_text, sizeof(status_text), _("Saved, %i steps failed"), sj->failed);
+    } else {
+        snprintf(status_text, sizeof(status_text), _("Saved in %.1fs"), sj->time);
+    }
+    show_save_status(designer);
+    scheduler_timeout(designer->scheduler, 5000, clear_save_status, designer);
+    int i = 0;
+    for (;i<sj->steps;i++) {
+        free(sj->step[i].path);
+        free(sj->step[i].text);
+        free(sj->step[i].json_path);
+        free(sj->step[i].source);
+        free(sj->step[i].copy);
+        free(sj->step[i].var);
+    }
+    for (i=0;i<sj->hashes;i++) {
+        free(sj->hash[i].file);
+    }
+    free(sj->hash);
+    atlas_free(&sj->atlas);
+    free(sj->bundle);
+    free(sj->step);
+    free(sj);
+}
+
 void run_save(void *w_, void* user_data) {
     Widget_t *w = (Widget_t*)w_;
     XUiDesigner *designer = (XUiDesigner*)w->parent_struct;
     if(user_data !=NULL) {
+        if (designer->save_job) {
+            Widget_t *dia = open_message_dialog(designer->ui, INFO_BOX, _("INFO"),
+                                            _("Please wait, the last save is still running"),NULL);
+            XSetTransientForHint(w->app->dpy, dia->widget, designer->ui->widget);
+            return;
+        }
         if( access(*(const char**)user_data, F_OK ) == -1 ) {
             Widget_t *dia = open_message_dialog(w, ERROR_BOX, *(const char**)user_data,
                                                 _("Couldn't access file, sorry"),NULL);
@@ -427,35 +1116,25 @@ void run_save(void *w_, void* user_data) {
         XFetchName(designer->ui->app->dpy, wi, &name);
         if (name == NULL) asprintf(&name, "%s", "noname");
         strdecode(name, " ", "_");
-        char* filepath = NULL;
-        asprintf(&filepath, "%s%s_ui",*(const char**)user_data,name);
-        struct stat st = {0};
+        const char *directory = *(const char**)user_data;
 
-        if (stat(filepath, &st) == -1) {
-            mkdir(filepath, 0700);
-        }
+        // everything is generated here, the worker only writes files and runs commands
+        SaveJob *sj = (SaveJob*)calloc(1, sizeof(SaveJob));
+        atlas_init(&sj->atlas);
+        collect_shared_images(designer);
+        sj->designer = designer;
+        sj->ex = designer->executor;
+        char* filepath = NULL;
+        asprintf(&filepath, "%s%s_ui",directory,name);
+        sj->bundle = strdup(filepath);
+        save_mkdir(sj, "%s", filepath);
 
         char* cmd = NULL;
         char* filename = NULL;
-        FILE *fpm = NULL;
-        char* makefile = NULL;
-        int ret = 0;
+        char* text = NULL;
         if (!designer->regenerate_ui) {
-            asprintf(&cmd, "cd %s && git init", filepath);
-            ret = system(cmd);
-            free(cmd);
-            cmd = NULL;
-            struct stat sb;
-            asprintf(&filename, "%s/libxputty",filepath);
-            if (stat(filename, &sb) != 0 && !S_ISDIR(sb.st_mode)) {
-                asprintf(&cmd, "cd %s && git submodule add https://github.com/brummer10/libxputty.git", filepath);
-                ret = system(cmd);
-                free(cmd);
-                cmd = NULL;
-            }
-            free(filename);
-            filename = NULL;
-            asprintf(&cmd, "SUBDIR := %s\n\n"
+            save_repository(sj, designer, filepath);
+            int len = asprintf(&text, "SUBDIR := %s\n\n"
 
                 ".PHONY: $(SUBDIR) libxputty  recurse\n\n"
 
@@ -468,344 +1147,138 @@ void run_save(void *w_, void* user_data) {
 
                 "$(SUBDIR): libxputty\n"
                 "	@exec $(MAKE) -j 1 -C $@ $(MAKECMDGOALS)\n\n", name);
+            save_text(sj, text, len < 0 ? 0 : len, false, "%s/makefile",filepath);
+            text = NULL;
+        }
 
-            asprintf(&makefile, "%s/makefile",filepath);
-            if((fpm=freopen(makefile, "w" ,stdout))==NULL) {
-                printf("open failed\n");
-            }
-            printf("%s", cmd);
-            fclose(fpm);
-            fpm = NULL;
-            free(makefile);
-            makefile = NULL;
-            free(cmd);
-            cmd = NULL;
-        }
-
-        char *json_file = NULL;
-        asprintf(&json_file, "%s/%s.json",filepath,name);
-        if((fpm=freopen(json_file, "w" ,stdout))==NULL) {
-            printf("open failed\n");
-        }
-        print_json(designer, filepath);
-        fclose(fpm);
-        fpm = NULL;
-        free(json_file);
-        json_file = NULL;
+        sj->parallel = true;
+        save_json(sj, filepath, "%s/%s.json",filepath,name);
+        sj->parallel = false;
 
         free(filepath);
         filepath = NULL;
-        asprintf(&filepath, "%s%s_ui/%s",*(const char**)user_data, name, name);
-
-        if (stat(filepath, &st) == -1) {
-            mkdir(filepath, 0700);
-        }
-
-        asprintf(&filename, "%s%s_ui/%s/%s.c",*(const char**)user_data,name,name, name );
-        remove (filename);
-
-        FILE *fp;
-        if((fp=freopen(filename, "w" ,stdout))==NULL) {
-            printf("open failed\n");
-        }
-        fprintf(stderr, "save to %s\n", filename);
-        print_list(designer);
-        fclose(fp);
-        fp = NULL;
+        asprintf(&filepath, "%s%s_ui/%s",directory, name, name);
+        save_mkdir(sj, "%s", filepath);
 
+        sj->parallel = true;
+        fprintf(stderr, "save to %s/%s.c\n", filepath, name);
+        save_file(sj, print_list, false, "%s/%s.c", filepath, name);
 
         if (!designer->regenerate_ui) {
             if (!designer->generate_ui_only) {
-                free(filename);
-                filename = NULL;
                 if (!designer->is_faust_synth_file) {
-                    asprintf(&filename, "%s%s_ui/%s/%s.cpp",*(const char**)user_data,name,name, name );
-                    if((fp=freopen(filename, "w" ,stdout))==NULL) {
-                        printf("open failed\n");
-                    }
-                    print_plugin(designer);
-                    fclose(fp);
-                    fp = NULL;
+                    save_file(sj, print_plugin, false, "%s/%s.cpp", filepath, name);
                 } else {
-                    asprintf(&filename, "%s%s_ui/%s/%s.cpp",*(const char**)user_data,name,name, name );
-                    asprintf(&cmd, "cp %s %s", designer->faust_synth_file, filename);
-                    ret = system(cmd);
-                    free(cmd);
-                    cmd = NULL;
+                    save_copy(sj, designer->faust_synth_file, false, "%s/%s.cpp", filepath, name);
                 }
-                strdecode(filename, ".cpp", ".ttl");
+                save_file(sj, print_ttl, false, "%s/%s.ttl", filepath, name);
             } else {
-                free(filename);
-                filename = NULL;
-                asprintf(&filename, "%s%s_ui/%s/%s_ui.ttl",*(const char**)user_data,name,name,name);
+                save_file(sj, print_ttl, false, "%s/%s_ui.ttl", filepath, name);
             }
+            save_file(sj, print_manifest, false, "%s/manifest.ttl", filepath);
 
-            if((fp=freopen(filename, "w" ,stdout))==NULL) {
-                printf("open failed\n");
-            }
-            print_ttl(designer);
-            fclose(fp);
-            fp = NULL;
-            free(filename);
-            filename = NULL;
-            asprintf(&filename, "%s%s_ui/%s/manifest.ttl",*(const char**)user_data,name,name);
-            if((fp=freopen(filename, "w" ,stdout))==NULL) {
-                printf("open failed\n");
-            }
-            print_manifest(designer);
-            fclose(fp);
-            fp = NULL;
-            free(filename);
-            filename = NULL;
             if (system(NULL)) {
-                cmd = NULL;
-
                 if (designer->is_faust_file) {
-                    asprintf(&cmd, "cp %s \'%s\'", designer->faust_file, filepath);
-                    ret = system(cmd);
-                    if (!ret) {
-                        free(cmd);
-                        cmd = NULL;
-                    }
-                    if ((fp=fopen(designer->faust_file, "r"))==NULL) {
-                        printf("open failed\n");
+                    save_copy(sj, designer->faust_file, false, "%s/%s", filepath, file_name(designer->faust_file));
+                    FILE *fpf;
+                    if ((fpf=fopen(designer->faust_file, "r"))==NULL) {
+                        fprintf(stderr, "open failed\n");
                     }
                     char buf[128];
-                    char* directory = strdup(designer->faust_path);
-                    while (fgets(buf, 127, fp) != NULL) {
+                    char* faust_dir = strdup(designer->faust_path);
+                    while (fpf != NULL && fgets(buf, 127, fpf) != NULL) {
                         if (strstr(buf, "#include \"") != NULL) {
                             char *ptr = strtok(buf, "\"");
                             ptr = strtok(NULL, "\"");
                             if (strstr(ptr, "math.h") == NULL) {
-                                asprintf(&filename, "%s/%s", directory,ptr);
+                                asprintf(&filename, "%s/%s", faust_dir,ptr);
                                 if (access(filename, F_OK) == 0) {
-                                    asprintf(&cmd, "cp %s \'%s\'", filename, filepath);
-                                    ret = system(cmd);
-                                    if (!ret) {
-                                        free(cmd);
-                                        cmd = NULL;
-                                    }
+                                    save_copy(sj, filename, false, "%s/%s", filepath, file_name(filename));
                                 } else {
-                                    fprintf(stderr, " could not access %i %s\n", ret, filename);
+                                    fprintf(stderr, " could not access %s\n", filename);
                                 }
                                 free(filename);
                                 filename = NULL;
                             }
                         }
                     }
-                    fclose(fp);
-                    fp = NULL;
-                    free(directory);
-                    directory = NULL;
+                    if (fpf != NULL) fclose(fpf);
+                    free(faust_dir);
+                    faust_dir = NULL;
                 }
                 if (designer->is_cc_file) {
-                    asprintf(&cmd, "cp %s \'%s\'", designer->cc_file, filepath);
-                    ret = system(cmd);
-                    if (!ret) {
-                        free(cmd);
-                        cmd = NULL;
-                    }
-                    free(cmd);
-                    cmd = NULL;
+                    save_copy(sj, designer->cc_file, false, "%s/%s", filepath, file_name(designer->cc_file));
                 }
 
                 asprintf(&filename, "%s/XUiDesigner/wrapper/libxputty/lv2_plugin.h", SHARE_DIR);
                 if (access(filename, F_OK) == 0) {
-                    asprintf(&cmd, "cp %s/XUiDesigner/wrapper/libxputty/lv2_plugin.* \'%s\'", SHARE_DIR, filepath);
+                    asprintf(&cmd, "%s/XUiDesigner/wrapper/libxputty", SHARE_DIR);
                 } else if (access("./Bundle/wrapper/libxputty/lv2_plugin.h", F_OK) == 0) {
-                    asprintf(&cmd, "cp ./Bundle/wrapper/libxputty/lv2_plugin.* \'%s\'", filepath);
+                    asprintf(&cmd, "./Bundle/wrapper/libxputty");
                 } else if (access("../Bundle/wrapper/libxputty/lv2_plugin.h", F_OK) == 0) {
-                    asprintf(&cmd, "cp ../Bundle/wrapper/libxputty/lv2_plugin.* \'%s\'", filepath);
+                    asprintf(&cmd, "../Bundle/wrapper/libxputty");
                 } else {
                     open_message_dialog(designer->ui, ERROR_BOX, "",
                         "Fail to copy libxputty wrapper files", NULL);   
                 }
                 free(filename);
                 filename = NULL;
-                ret = system(cmd);
-                if (!ret) {
-                    asprintf(&makefile, "%s/makefile",filepath);
-                    FILE *fpmu;
-                    if((fpmu=freopen(makefile, "w" ,stdout))==NULL) {
-                        printf("open failed\n");
-                    }
-                    print_makefile(designer);
-                    fclose(fpmu);
-                    free(makefile);
-                    free(cmd);
-                    cmd = NULL;
-                    //asprintf(&cmd, "cd \'%s\'  && make", filepath);
-                    //ret = system(cmd);
-                    //free(cmd);
-                    //cmd = NULL;
-                } else {
+                if (cmd != NULL) {
+                    // the makefile only gets written when the wrapper is in place
+                    asprintf(&filename, "%s/lv2_plugin.h", cmd);
+                    save_copy(sj, filename, false, "%s/lv2_plugin.h", filepath);
+                    free(filename);
+                    asprintf(&filename, "%s/lv2_plugin.cc", cmd);
+                    save_copy(sj, filename, true, "%s/lv2_plugin.cc", filepath);
+                    free(filename);
+                    filename = NULL;
+                    save_file(sj, print_makefile, true, "%s/makefile", filepath);
                     free(cmd);
                     cmd = NULL;
                 }
             }
-            free(filepath);
-            filepath = NULL;
         }
+        sj->parallel = false;
+        free(filepath);
+        filepath = NULL;
 
-        cmd = NULL;
         if (have_image || designer->image != NULL) {
-            asprintf(&filepath, "%s%s_ui/resources",*(const char**)user_data,name);
-            if (stat(filepath, &st) == -1) {
-                mkdir(filepath, 0700);
-            } else if (!designer->regenerate_ui) {
-                asprintf(&cmd, "rm -rf \'%s\'", filepath);
-                int retu = system(cmd);
-                if (!retu) {
-                    free(cmd);
-                    cmd = NULL;
-                    mkdir(filepath, 0700);
-                } else {
-                    free(cmd);
-                    cmd = NULL;
-                }
+            asprintf(&filepath, "%s%s_ui/resources",directory,name);
+            if (!designer->regenerate_ui) {
+                save_remove(sj, "%s", filepath);
             }
+            save_mkdir(sj, "%s", filepath);
         }
 
-        if (designer->image != NULL) {
-            //png2c(designer->image,filepath);
-            char* tmp = strdup(designer->image);
-            char* xldl = strdup(basename(tmp));
-            free(tmp);
-            tmp = NULL;
-            strdecode(xldl, "-", "_");
-            strdecode(xldl, " ", "_");
-            strtovar(xldl);
-            if (strstr(designer->image, ".png")) {
-                strdecode(xldl, "_png", ".png");
-                char* fxldl = NULL;
-                asprintf(&fxldl, "%s/%s", filepath, xldl);
-                if (strcmp(designer->image,fxldl)) {
-                    asprintf(&cmd, "cp \'%s\' \'%s\'", designer->image,fxldl);
-                    int retu = system(cmd);
-                    if (!retu) {
-                        char* xldc =  strdup(xldl);
-                        strdecode(xldc, ".png", ".c");
-                        free(cmd);
-                        cmd = NULL;
-                        asprintf(&cmd, "cd %s && xxd -i %s > %s", filepath, xldl, xldc);
-                        retu = system(cmd);
-                        free(xldc);
-                        free(cmd);
-                        cmd = NULL;
-                    } else {
-                        free(cmd);
-                        cmd = NULL;
-                        fprintf(stderr, "Fail to copy image\n");
-                    }
-                }
-                free(fxldl);
-            } else if (strstr(designer->image, ".svg")) {
-                char* xldv = strdup(xldl);
-                strdecode(xldl, "_svg", ".svg");
-                char* fxldl = NULL;
-                asprintf(&fxldl, "%s/%s", filepath, xldl);
-                if (strcmp(designer->image,fxldl)) {
-                    asprintf(&cmd, "cp \'%s\' \'%s\'", designer->image,fxldl);
-                    int retu = system(cmd);
-                    if (!retu) {
-                        char* xldc =  strdup(xldl);
-                        strdecode(xldc, ".svg", ".c");
-                        free(cmd);
-                        cmd = NULL;
-                        asprintf(&cmd, "cd %s && echo 'const char* %s = \"'| tr -d '\r\n' > %s && base64 %s | tr -d '\r\n' >> %s && echo '\";' >> %s", filepath, xldv, xldc, xldl, xldc, xldc);
-                        retu = system(cmd);
-                        free(xldc);
-                        free(cmd);
-                        cmd = NULL;
-                    } else {
-                        free(cmd);
-                        cmd = NULL;
-                        fprintf(stderr, "Fail to copy image\n");
-                    }
-                }
-                free(fxldl);
-                free(xldv);
+        // one copy per image content, the generators name the same one
+        sj->parallel = true;
+        for (i=0;i<designer->shared_images;i++) {
+            if (designer->shared_image[i].same == i) {
+                save_image(sj, designer->shared_image[i].image, filepath);
+            }
+        }
+        if ((have_image || designer->image != NULL) && adj_get_value(designer->startup_images->adj)) {
+            atlas_collect(designer, &sj->atlas);
+            for (i=0;i<sj->atlas.pages;i++) {
+                save_atlas(sj, i, "%s/xui_atlas%i.h", filepath, i);
             }
-            free(xldl);
         }
         if (have_image) {
-            i = 0;
-            for (;i<MAX_CONTROLS;i++) {
-                if (designer->controls[i].image != NULL) {
-                    //png2c(designer->controls[i].image,filepath);
-                    char* tmp = strdup(designer->controls[i].image);
-                    char* xldl = strdup(basename(tmp));
-                    free(tmp);
-                    tmp = NULL;
-                    strdecode(xldl, "-", "_");
-                    strdecode(xldl, " ", "_");
-                    strtovar(xldl);
-                    if (strstr(designer->controls[i].image, ".png")) {
-                        strdecode(xldl, "_png", ".png");
-                        char* fxldl = NULL;
-                        asprintf(&fxldl, "%s/%s", filepath, xldl);
-                        if (strcmp(designer->controls[i].image,fxldl)) {
-                            asprintf(&cmd, "cp \'%s\' \'%s\'", designer->controls[i].image,fxldl);
-                            int retu = system(cmd);
-                            if (!retu) {
-                                char* xldc = strdup(xldl);
-                                strdecode(xldc, ".png", ".c");
-                                free(cmd);
-                                cmd = NULL;
-                                asprintf(&cmd, "cd %s && xxd -i %s > %s", filepath, xldl, xldc);
-                                retu = system(cmd);
-                                free(xldc);
-                                free(cmd);
-                                cmd = NULL;
-                            } else {
-                                free(cmd);
-                                cmd = NULL;
-                                fprintf(stderr, "Fail to copy image\n");
-                            }
-                        }
-                        free(fxldl);
-                    } else if (strstr(designer->controls[i].image, ".svg")) {
-                        char* xldv = strdup(xldl);
-                        strdecode(xldl, "_svg", ".svg");
-                        char* fxldl = NULL;
-                        asprintf(&fxldl, "%s/%s", filepath, xldl);
-                        if (strcmp(designer->controls[i].image,fxldl)) {
-                            asprintf(&cmd, "cp \'%s\' \'%s\'", designer->controls[i].image,fxldl);
-                            int retu = system(cmd);
-                            if (!retu) {
-                                char* xldc =  strdup(xldl);
-                                strdecode(xldc, ".svg", ".c");
-                                free(cmd);
-                                cmd = NULL;
-                                asprintf(&cmd, "cd %s && echo 'const char* %s = \"'| tr -d '\r\n' > %s && base64 %s | tr -d '\r\n' >> %s && echo '\";' >> %s", filepath, xldv, xldc, xldl, xldc, xldc);
-                                retu = system(cmd);
-                                free(xldc);
-                                free(cmd);
-                                cmd = NULL;
-                            } else {
-                                free(cmd);
-                                cmd = NULL;
-                                fprintf(stderr, "Fail to copy image\n");
-                            }
-                        }
-                        free(fxldl);
-                        free(xldv);
-                    }
-                    free(xldl);
-                    
-                }
+            sj->parallel = false;
+            if (designer->repo_setup == REPO_SUBMODULE || designer->repo_setup == REPO_MIRROR) {
+                save_shell(sj, false, "git add", "cd %s%s_ui && git add .", directory, name);
             }
-            free(filepath);
-            filepath = NULL;
-            asprintf(&filepath, "%s%s_ui",*(const char**)user_data,name);
-            char* cmdc = NULL;
-            asprintf(&cmdc, "cd %s && git add .", filepath);
-            ret = system(cmdc);
-            free(cmdc);
-            cmdc = NULL;
-            free(filepath);
-            free(name);
         }
+        free(filepath);
+        filepath = NULL;
+        free(name);
+        name = NULL;
+
+        generate_save_files(sj, designer);
+        snprintf(status_text, sizeof(status_text), _("Saving ..."));
+        show_save_status(designer);
+        designer->save_job = executor_submit(designer->executor, save_bundle,
+                                        save_finished, save_progress, sj);
     }
 }
 
@@ -816,10 +1289,221 @@ void run_save(void *w_, void* user_data) {
 -----------------------------------------------------------------------
 ----------------------------------------------------------------------*/
 
+static void test_hide_designer(XUiDesigner *designer) {
+    if ((int)adj_get_value(designer->color_chooser->adj)) {
+        adj_set_value(designer->color_chooser->adj, 0.0);
+    }
+    widget_hide_all(designer->w);
+    //widget_hide(designer->ui);
+    //widget_hide(designer->set_project);
+    XFlush(designer->w->app->dpy);
+}
+
+static void test_finished(XUiDesigner *designer, Widget_t *w, int ret) {
+    designer->run_test = false;
+    widget_show_all(designer->w);
+    widget_show_all(designer->ui);
+    hide_show_as_needed(designer);
+    if (ret) {
+        Widget_t *dia = open_message_dialog(designer->ui, INFO_BOX, _("INFO"),
+                                        _("Test fail, sorry"),NULL);
+        XSetTransientForHint(w->app->dpy, dia->widget, designer->ui->widget);
+    }
+}
+
+// xuipreview is built and installed along with the designer
+static char *preview_runtime() {
+    char *runtime = NULL;
+    asprintf(&runtime, "%s/XUiDesigner/xuipreview", SHARE_DIR);
+    if (access(runtime, X_OK) == 0) return runtime;
+    free(runtime);
+    if (access("./XUiDesigner/build/xuipreview", X_OK) == 0) {
+        return strdup("./XUiDesigner/build/xuipreview");
+    } else if (access("./build/xuipreview", X_OK) == 0) {
+        return strdup("./build/xuipreview");
+    }
+    return NULL;
+}
+
+#define TEST_CFLAGS "-O2 -D_FORTIFY_SOURCE=2 -Wall -fstack-protector -fPIC"
+
+static void hash_wrapper_file(XUiString *key, const char *wrapper, const char *file) {
+    char *path = NULL;
+    unsigned char *data = NULL;
+    size_t len = 0;
+    asprintf(&path, "%s/%s", wrapper, file);
+    if (!embed_read_file(path, &data, &len)) {
+        xstring_append_len(key, (const char*)data, len);
+        free(data);
+    }
+    free(path);
+}
+
+// a new object replaces the ones built from an older wrapper or toolchain
+static void test_prune_objects(const char *dir, const char *keep) {
+    DIR *d = opendir(dir);
+    if (!d) return;
+    struct dirent *e;
+    while ((e = readdir(d)) != NULL) {
+        if (strncmp(e->d_name, "ui_test-", 8) != 0 || strcmp(e->d_name, keep) == 0) continue;
+        if (!strstr(e->d_name, ".o")) continue;
+        char *path = NULL;
+        asprintf(&path, "%s/%s", dir, e->d_name);
+        unlink(path);
+        free(path);
+    }
+    closedir(d);
+}
+
+// ui_test.cc only changes with the wrapper, so it gets compiled once for each
+// compiler, flags and source and the test build just links the cached object
+static char *test_wrapper_object(const char *wrapper) {
+    char *flags = NULL;
+    asprintf(&flags, TEST_CFLAGS " -DCONTROLS=%i -DGUI_ELEMENTS=%i -DTAB_ELEMENTS=%i "
+        "`pkg-config lilv-0 --cflags` `pkg-config --cflags xputty cairo x11`",
+        TEST_CONTROLS, TEST_GUI_ELEMENTS, TEST_TAB_ELEMENTS);
+    XUiString key;
+    xstring_init(&key);
+    xstring_append(&key, flags);
+    FILE *fp = popen("cc -dumpfullversion -dumpmachine 2>/dev/null; "
+                    "pkg-config --modversion --cflags xputty cairo x11 lilv-0 2>/dev/null", "r");
+    if (fp) {
+        char buf[256];
+        size_t r = 0;
+        while ((r = fread(buf, 1, sizeof(buf), fp)) > 0) xstring_append_len(&key, buf, r);
+        pclose(fp);
+    }
+    hash_wrapper_file(&key, wrapper, "ui_test.cc");
+    hash_wrapper_file(&key, wrapper, "lv2_plugin.h");
+    unsigned long long hash = hash_data(key.str, key.len);
+    xstring_free(&key);
+
+    char *dir = NULL;
+    const char *cache = getenv("XDG_CACHE_HOME");
+    if (cache && *cache) {
+        asprintf(&dir, "%s/xuidesigner", cache);
+    } else {
+        asprintf(&dir, "%s/.cache", getenv("HOME"));
+        mkdir(dir, 0755);
+        free(dir);
+        asprintf(&dir, "%s/.cache/xuidesigner", getenv("HOME"));
+    }
+    mkdir(dir, 0755);
+    char *object = NULL;
+    asprintf(&object, "%s/ui_test-%016llx.o", dir, hash);
+    if (access(object, R_OK) == 0) {
+        free(dir);
+        free(flags);
+        return object;
+    }
+    char *cmd = NULL;
+    asprintf(&cmd, "cc %s -x c -c \"%s/ui_test.cc\" -o \"%s.tmp\" && mv \"%s.tmp\" \"%s\"",
+                                            flags, wrapper, object, object, object);
+    int ret = system(cmd);
+    free(cmd);
+    free(flags);
+    if (ret) {
+        free(dir);
+        free(object);
+        return NULL;
+    }
+    test_prune_objects(dir, strrchr(object, '/') + 1);
+    free(dir);
+    return object;
+}
+
+// the test build compiles and runs the ui on a worker, the designer stays hidden meanwhile
+typedef struct {
+    XUiDesigner *designer;
+    Widget_t *w;
+    bool copy_failed;
+    int ret;
+} TestBuild;
+
+// a wrapper from the source tree gets copied next to test.c
+static char *test_wrapper_copy(const char *source) {
+    const char *files[] = {"ui_test.cc", "lv2_plugin.h"};
+    int i = 0;
+    for (;i<2;i++) {
+        char *from = NULL;
+        char *to = NULL;
+        asprintf(&from, "%s/%s", source, files[i]);
+        asprintf(&to, "/tmp/%s", files[i]);
+        int ret = files_copy(from, to);
+        free(from);
+        free(to);
+        if (ret) return NULL;
+    }
+    return strdup("/tmp");
+}
+
+static char *test_wrapper_path() {
+    char* filename = NULL;
+    char* filepath = NULL;
+    asprintf(&filename, "%s/XUiDesigner/wrapper/libxputty/ui_test.cc", SHARE_DIR);
+    if (access(filename, F_OK) == 0) {
+        asprintf(&filepath, "%s/XUiDesigner/wrapper/libxputty", SHARE_DIR);
+    } else if (access("./Bundle/wrapper/libxputty/ui_test.cc", F_OK) == 0) {
+        filepath = test_wrapper_copy("./Bundle/wrapper/libxputty");
+    } else if (access("../Bundle/wrapper/libxputty/ui_test.cc", F_OK) == 0) {
+        filepath = test_wrapper_copy("../Bundle/wrapper/libxputty");
+    }
+    free(filename);
+    return filepath;
+}
+
+static void test_build_run(XUiJob* UNUSED(job), void *data) {
+    TestBuild *tb = (TestBuild*)data;
+    char *filepath = test_wrapper_path();
+    if (!filepath) {
+        tb->copy_failed = true;
+        return;
+    }
+    // with a cached wrapper object test.c leaves out ui_test.cc and gets linked
+    // against the object, without one test.c includes ui_test.cc itself
+    char *object = test_wrapper_object(filepath);
+    char *sources = NULL;
+    if (object) {
+        asprintf(&sources, "-DXUI_TEST_OBJECT test.c \"%s\"", object);
+    } else {
+        sources = strdup("test.c");
+    }
+    char* cmd = NULL;
+    asprintf(&cmd, "cd /tmp/  && "
+        "cc " TEST_CFLAGS " "
+        "`pkg-config lilv-0 --cflags` %s "
+        "-o uitest -Wl,-z,noexecstack -Wl,--no-undefined -I./ "
+        "-I%s "
+        "-Wl,-Bstatic `pkg-config --cflags --libs xputty` "
+        "-Wl,-Bdynamic `pkg-config --cflags --libs cairo x11 lilv-0` -lm ",
+        sources, filepath);
+    free(sources);
+    free(object);
+    free(filepath);
+    tb->ret = system(cmd);
+    free(cmd);
+    if (!tb->ret) {
+        tb->ret = system("cd /tmp/  && ./uitest");
+    }
+}
+
+static void test_build_done(XUiJob* UNUSED(job), void *data) {
+    TestBuild *tb = (TestBuild*)data;
+    XUiDesigner *designer = tb->designer;
+    designer->test_job = NULL;
+    test_finished(designer, tb->w, tb->copy_failed ? 0 : tb->ret);
+    if (tb->copy_failed) {
+        open_message_dialog(designer->ui, ERROR_BOX, "",
+            "Fail to copy libxputty wrapper files", NULL);   
+    }
+    free(tb);
+}
+
 void run_test(void *w_, void* UNUSED(user_data)) {
     Widget_t *w = (Widget_t*)w_;
     XUiDesigner *designer = (XUiDesigner*)w->parent_struct;
     if (w->flags & HAS_POINTER && !adj_get_value(w->adj_y)) {
+        if (designer->test_job) return;
         int i = 0;
         int j = 0;
         for (;i<MAX_CONTROLS;i++) {
@@ -833,78 +1517,40 @@ void run_test(void *w_, void* UNUSED(user_data)) {
             XSetTransientForHint(w->app->dpy, dia->widget, designer->ui->widget);
             return;
         }
+        // the preview runs next to the designer and follows the edits
+        if (designer->live_preview) {
+            live_preview_sync(designer->live_preview);
+            return;
+        }
+        char *runtime = preview_runtime();
+        if (runtime) {
+            designer->live_preview = live_preview_start(designer, runtime);
+            free(runtime);
+            if (designer->live_preview) return;
+        }
+        // the event loop keeps running during the test, only this print_list() call is the test ui
         designer->run_test = true;
         char* name = "/tmp/test.c";
-        remove (name);
-        FILE *fp;
-        if((fp=freopen(name, "w" ,stdout))==NULL) {
+        XUiString test;
+        xstring_init(&test);
+        print_list(designer, &test);
+        designer->run_test = false;
+        int fail = xstring_write_file(&test, name);
+        xstring_free(&test);
+        if (fail) {
             fprintf(stderr,"open failed\n");
             return;
         }
-
-        print_list(designer);
-        fclose(fp);
         if (system(NULL)) {
-            if ((int)adj_get_value(designer->color_chooser->adj)) {
-                adj_set_value(designer->color_chooser->adj, 0.0);
-            }
-            widget_hide_all(designer->w);
-            //widget_hide(designer->ui);
-            //widget_hide(designer->set_project);
-            XFlush(designer->w->app->dpy);
-
-            char* cmd = NULL;
-            char* filename = NULL;
-            char* filepath = NULL;
-            int ret = 1;
-            asprintf(&filename, "%s/XUiDesigner/wrapper/libxputty/ui_test.cc", SHARE_DIR);
-            if (access(filename, F_OK) == 0) {
-                asprintf(&filepath, "%s/XUiDesigner/wrapper/libxputty", SHARE_DIR);
-                ret = 0;
-            } else if (access("./Bundle/wrapper/libxputty/ui_test.cc", F_OK) == 0) {
-                ret = system("cp ./Bundle/wrapper/libxputty/ui_test.cc ./Bundle/wrapper/libxputty/lv2_plugin.h /tmp/");
-                if (!ret) asprintf(&filepath, "%s", "./");
-            } else if (access("../Bundle/wrapper/libxputty/ui_test.cc", F_OK) == 0) {
-                ret = system("cp ../Bundle/wrapper/libxputty/ui_test.cc ../Bundle/wrapper/libxputty/lv2_plugin.h /tmp/");
-                if (!ret) asprintf(&filepath, "%s", "./");
-            }
-            if (ret) {
-                open_message_dialog(designer->ui, ERROR_BOX, "",
-                    "Fail to copy libxputty wrapper files", NULL);   
-            }
-            free(filename);
-            filename = NULL;
-
-            asprintf(&cmd, "cd /tmp/  && "
-                "cc -O2 -D_FORTIFY_SOURCE=2 -Wall -fstack-protector "
-                "`pkg-config lilv-0 --cflags` test.c "
-                "-o uitest  -fPIC -Wl,-z,noexecstack -Wl,--no-undefined -I./ "
-                "-I%s "
-                "-Wl,-Bstatic `pkg-config --cflags --libs xputty` "
-                "-Wl,-Bdynamic `pkg-config --cflags --libs cairo x11 lilv-0` -lm ", filepath);
-
-            ret = system(cmd);
-            free(cmd);
-            cmd = NULL;
-            free(filepath);
-            filepath = NULL;
-            if (!ret) {
-                ret = system("cd /tmp/  && ./uitest");
-            }
-            if (!ret) {
-                designer->run_test = false;
-                widget_show_all(designer->w);
-                widget_show_all(designer->ui);
-                hide_show_as_needed(designer);
-            } else {
-                designer->run_test = false;
-                widget_show_all(designer->w);
-                widget_show_all(designer->ui);
-                hide_show_as_needed(designer);
-                Widget_t *dia = open_message_dialog(designer->ui, INFO_BOX, _("INFO"),
-                                                _("Test fail, sorry"),NULL);
-                XSetTransientForHint(w->app->dpy, dia->widget, designer->ui->widget);
-            }
+            test_hide_designer(designer);
+
+            TestBuild *tb = (TestBuild*)malloc(sizeof(TestBuild));
+            tb->designer = designer;
+            tb->w = w;
+            tb->copy_failed = false;
+            tb->ret = 1;
+            designer->test_job = executor_submit(designer->executor, test_build_run,
+                                                        test_build_done, NULL, tb);
         }
     }
 }
@@ -105,6 +105,86 @@ Widget_t *add_image_load_button(Widget_t *parent, int x, int y, int width, int h
 -----------------------------------------------------------------------
 ----------------------------------------------------------------------*/
 
+/*---------------------------------------------------------------------
+-----------------------------------------------------------------------    
+                slice sprite strips into single frames
+-----------------------------------------------------------------------
+----------------------------------------------------------------------*/
+
+// hand only the frame matching the adjustment state to the widget draw function
+static void draw_sprite_frame(void *w_, void* user_data) {
+    Widget_t *w = (Widget_t*)w_;
+    Widget_t *p = (Widget_t*)w->parent;
+    XUiDesigner *designer = (XUiDesigner*)p->parent_struct;
+    Controller *c = &designer->controls[w->data];
+    ControllerSprites *sprites = &c->sprites;
+    if (!sprites->count || !w->image) {
+        sprites->expose(w_, user_data);
+        return;
+    }
+    int findex = (int)((sprites->count-1) * adj_get_state(w->adj));
+    bool is_slider = (c->is_type == IS_VSLIDER || c->is_type == IS_HSLIDER);
+    cairo_surface_t *strip = w->image;
+    w->image = sprites->frame[findex];
+    if (is_slider) set_slider_image_frame_count(w, 1);
+    sprites->expose(w_, user_data);
+    if (is_slider) set_slider_image_frame_count(w, c->slider_image_sprites);
+    w->image = strip;
+}
+
+void sprite_frames_free(XUiDesigner *designer, Widget_t *wid) {
+    ControllerSprites *sprites = &designer->controls[wid->data].sprites;
+    int i = 0;
+    for (;i<sprites->count;i++) {
+        cairo_surface_destroy(sprites->frame[i]);
+    }
+    free(sprites->frame);
+    sprites->frame = NULL;
+    sprites->count = 0;
+    if (sprites->expose && wid->func.expose_callback == draw_sprite_frame)
+        wid->func.expose_callback = sprites->expose;
+    sprites->expose = NULL;
+}
+
+void sprite_frames_slice(XUiDesigner *designer, Widget_t *wid) {
+    sprite_frames_free(designer, wid);
+    Controller *c = &designer->controls[wid->data];
+    ControllerSprites *sprites = &c->sprites;
+    if (!wid->image) return;
+    int width = cairo_xlib_surface_get_width(wid->image);
+    int height = cairo_xlib_surface_get_height(wid->image);
+    int count = 0;
+    if (c->is_type == IS_KNOB) {
+        count = width/max(1,height);
+    } else if (c->is_type == IS_VSLIDER || c->is_type == IS_HSLIDER) {
+        count = c->slider_image_sprites;
+    }
+    // only horizontal strips with more then one frame need to be sliced
+    if (count < 2 || width < count) return;
+    int frame_width = width/count;
+    sprites->frame = (cairo_surface_t **)malloc(count * sizeof(cairo_surface_t *));
+    int i = 0;
+    for (;i<count;i++) {
+        sprites->frame[i] = cairo_surface_create_similar (wid->surface,
+                            CAIRO_CONTENT_COLOR_ALPHA, frame_width, height);
+        cairo_t *cri = cairo_create (sprites->frame[i]);
+        cairo_set_source_surface (cri, wid->image, -frame_width*i, 0);
+        cairo_paint (cri);
+        cairo_destroy(cri);
+    }
+    sprites->count = count;
+    sprites->expose = wid->func.expose_callback;
+    wid->func.expose_callback = draw_sprite_frame;
+}
+
+void sprite_frames_free_all(XUiDesigner *designer) {
+    int i = 0;
+    for (;i<MAX_CONTROLS;i++) {
+        if (designer->controls[i].wid != NULL)
+            sprite_frames_free(designer, designer->controls[i].wid);
+    }
+}
+
 void image_load_response(void *w_, void* user_data) {
     Widget_t *w = (Widget_t*)w_;
     Widget_t *p = (Widget_t*)w->parent;
@@ -234,6 +314,7 @@ static void set_slider_frames(void *w_, void* UNUSED(user_data)) {
     XUiDesigner *designer = (XUiDesigner*)w->parent_struct;
     designer->controls[designer->active_widget_num].slider_image_sprites = (int)adj_get_value(w->adj);
     set_slider_image_frame_count(designer->active_widget, adj_get_value(w->adj));
+    sprite_frames_slice(designer, designer->active_widget);
 }
 
 static void load_for_all_global(XUiDesigner *designer, WidgetType is_type, cairo_surface_t *getpng,
@@ -258,6 +339,7 @@ static void load_for_all_global(XUiDesigner *designer, WidgetType is_type, cairo
             cairo_set_source_surface (cri, getpng,0,0);
             cairo_paint (cri);
             cairo_destroy(cri);
+            sprite_frames_slice(designer, designer->controls[i].wid);
             expose_widget(designer->controls[i].wid);
             free(designer->controls[i].image);
             designer->controls[i].image = NULL;
@@ -297,6 +379,7 @@ void load_single_controller_image (XUiDesigner *designer, const char* filename)
     cairo_paint (cri);
     cairo_surface_destroy(getpng);
     cairo_destroy(cri);
+    sprite_frames_slice(designer, designer->active_widget);
     expose_widget(designer->active_widget);
     free(designer->controls[designer->active_widget_num].image);
     designer->controls[designer->active_widget_num].image = NULL;
@@ -305,6 +388,7 @@ void load_single_controller_image (XUiDesigner *designer, const char* filename)
     designer->image_path = NULL;
     designer->image_path = strdup(dirname(tmp));
     free(tmp);
+    designer_changed(designer);
 }
 
 void controller_image_load_response(void *w_, void* user_data) {
@@ -406,6 +490,7 @@ void controller_image_load_response(void *w_, void* user_data) {
             cairo_paint (cri);
             cairo_surface_destroy(getpng);
             cairo_destroy(cri);
+            sprite_frames_slice(designer, designer->active_widget);
             expose_widget(designer->active_widget);
             free(designer->controls[designer->active_widget_num].image);
             designer->controls[designer->active_widget_num].image = NULL;
@@ -466,6 +551,7 @@ static void background_image_load_response(void *w_, void* user_data) {
         designer->image_path = NULL;
         designer->image_path = strdup(dirname(tmp));
         free(tmp);
+        designer_changed(designer);
     }
 }
 
@@ -479,6 +565,7 @@ static void unload_controller_image(void *w_, void* UNUSED(user_data)) {
         designer->controls[designer->active_widget_num].is_type == IS_VMETER ||
         designer->controls[designer->active_widget_num].is_type == IS_HMETER ||
         designer->controls[designer->active_widget_num].is_type == IS_LABEL) return;
+    sprite_frames_free(designer, w);
     cairo_surface_destroy(w->image);
     w->image = NULL;
     expose_widget(w);
@@ -488,6 +575,7 @@ static void unload_controller_image(void *w_, void* UNUSED(user_data)) {
         designer->controls[designer->active_widget_num].is_type == IS_IMAGE_BUTTON) {
         unset_image_button(designer, designer->controls[designer->active_widget_num].is_type);
     }
+    designer_changed(designer);
 }
 
 void pop_menu_response(void *w_, void* item_, void* UNUSED(user_data)) {
@@ -0,0 +1,364 @@
+/*
+ *                           0BSD 
+ * 
+ *                    BSD Zero Clause License
+ * 
+ *  Copyright (c) 2021 Hermann Meyer
+ *
+ * Permission to use, copy, modify, and/or distribute this software for any
+ * purpose with or without fee is hereby granted.
+
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES WITH
+ * REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY
+ * AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT,
+ * INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM
+ * LOSS OF USE, DATA OR PROFITS, WHETHER IN AN ACTION OF CONTRACT, NEGLIGENCE OR
+ * OTHER TORTIOUS ACTION, ARISING OUT OF OR IN CONNECTION WITH THE USE OR
+ * PERFORMANCE OF THIS SOFTWARE.
+ *
+ */
+
+
+#include <sys/socket.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <errno.h>
+#include <signal.h>
+#include <unistd.h>
+
+#include "XUiLivePreview.h"
+#include "XUiScheduler.h"
+#include "XUiWriteUI.h"
+#include "XUiString.h"
+
+
+/*---------------------------------------------------------------------
+-----------------------------------------------------------------------    
+        keep a xuipreview process in sync with the designer
+-----------------------------------------------------------------------
+----------------------------------------------------------------------*/
+
+#define LIVE_PREVIEW_INTERVAL 40
+#define LIVE_PREVIEW_RETRY 500
+
+// a description line, key names the value it sets, shape the widget it creates
+typedef struct {
+    const char *line;
+    int len;
+    int index;
+    char *key;
+    char *shape;
+} LiveLine;
+
+typedef struct {
+    char *text;
+    LiveLine *line;
+    int lines;
+} LiveDescription;
+
+struct XUiLivePreview {
+    XUiDesigner *designer;
+    pid_t pid;
+    int fd;
+    // the first description, the preview reads it at startup
+    char *path;
+    LiveDescription shown;
+    bool queued;
+    // a send failed, the preview may hold a cut line and needs the full description
+    bool resync;
+};
+
+// first count tab separated fields of the line
+static char *line_fields(const char *line, int len, int count) {
+    int i = 0;
+    for (;i<len;i++) {
+        if (line[i] == '\t' && --count == 0) break;
+    }
+    return strndup(line, i);
+}
+
+// the ref a line works on, frames and slice lines belong to the image of the widget
+static char *line_group(const char *name, const char *line, int len) {
+    char *ref = line_fields(line, len, 2);
+    char *tab = strchr(ref, '\t');
+    char *key = NULL;
+    asprintf(&key, "%s\t%s", name, tab ? tab+1 : "");
+    free(ref);
+    return key;
+}
+
+static void parse_line(LiveLine *l) {
+    if (strncmp(l->line, "elem\t", 5) == 0 || strncmp(l->line, "tab\t", 4) == 0) {
+        l->key = line_fields(l->line, l->len, 2);
+        l->shape = line_fields(l->line, l->len, 3);
+    } else if (strncmp(l->line, "widget\t", 7) == 0) {
+        l->key = line_fields(l->line, l->len, 2);
+        l->shape = line_fields(l->line, l->len, 4);
+    } else if (strncmp(l->line, "entry\t", 6) == 0) {
+        l->shape = strndup(l->line, l->len);
+    } else if (strncmp(l->line, "frames\t", 7) == 0 || strncmp(l->line, "slice\t", 6) == 0) {
+        l->key = line_group("image", l->line, l->len);
+    } else if (strncmp(l->line, "color\t", 6) == 0) {
+        l->key = line_fields(l->line, l->len, 4);
+    } else if (strncmp(l->line, "theme\t", 6) == 0 || strncmp(l->line, "image\t", 6) == 0 ||
+                                        strncmp(l->line, "adjustment\t", 11) == 0) {
+        l->key = line_fields(l->line, l->len, 2);
+    } else {
+        l->key = line_fields(l->line, l->len, 1);
+    }
+}
+
+static void description_free(LiveDescription *d) {
+    int i = 0;
+    for (;i<d->lines;i++) {
+        free(d->line[i].key);
+        free(d->line[i].shape);
+    }
+    free(d->line);
+    free(d->text);
+    d->text = NULL;
+    d->line = NULL;
+    d->lines = 0;
+}
+
+// takes over the text
+static void description_parse(LiveDescription *d, char *text) {
+    d->text = text;
+    d->lines = 0;
+    int count = 0;
+    char *c = text;
+    for (;*c;c++) {
+        if (*c == '\n') count++;
+    }
+    d->line = (LiveLine*)calloc(count+1, sizeof(LiveLine));
+    char *start = text;
+    for (c=text;*c;c++) {
+        if (*c != '\n') continue;
+        if (c > start) {
+            LiveLine *l = &d->line[d->lines];
+            l->line = start;
+            l->len = c - start;
+            l->index = d->lines++;
+            parse_line(l);
+        }
+        start = c+1;
+    }
+}
+
+static bool same_shape(LiveDescription *a, LiveDescription *b) {
+    int i = 0;
+    int j = 0;
+    for (;;) {
+        while (i<a->lines && !a->line[i].shape) i++;
+        while (j<b->lines && !b->line[j].shape) j++;
+        if (i == a->lines || j == b->lines) return i == a->lines && j == b->lines;
+        if (strcmp(a->line[i].shape, b->line[j].shape) != 0) return false;
+        i++;
+        j++;
+    }
+}
+
+static int compare_key(const void *a, const void *b) {
+    const LiveLine *la = *(const LiveLine**)a;
+    const LiveLine *lb = *(const LiveLine**)b;
+    int r = strcmp(la->key, lb->key);
+    return r ? r : la->index - lb->index;
+}
+
+static LiveLine **sorted_keys(LiveDescription *d, int *count) {
+    LiveLine **s = (LiveLine**)malloc((d->lines+1) * sizeof(LiveLine*));
+    *count = 0;
+    int i = 0;
+    for (;i<d->lines;i++) {
+        if (d->line[i].key) s[(*count)++] = &d->line[i];
+    }
+    qsort(s, *count, sizeof(LiveLine*), compare_key);
+    return s;
+}
+
+static int group_end(LiveLine **s, int count, int i) {
+    int e = i+1;
+    while (e < count && strcmp(s[e]->key, s[i]->key) == 0) e++;
+    return e;
+}
+
+static bool same_group(LiveLine **a, int ai, int ae, LiveLine **b, int bi, int be) {
+    if (ae - ai != be - bi) return false;
+    for (;ai<ae;ai++, bi++) {
+        if (a[ai]->len != b[bi]->len || memcmp(a[ai]->line, b[bi]->line, a[ai]->len) != 0)
+            return false;
+    }
+    return true;
+}
+
+// mark the lines of the new description which changed a value,
+// false when a value is gone and the preview needs to be rebuilt
+static bool mark_changes(LiveDescription *old, LiveDescription *now, bool *send) {
+    int no = 0;
+    int nn = 0;
+    LiveLine **so = sorted_keys(old, &no);
+    LiveLine **sn = sorted_keys(now, &nn);
+    bool ret = true;
+    int i = 0;
+    int j = 0;
+    while (j < nn || i < no) {
+        int r = i == no ? 1 : j == nn ? -1 : strcmp(so[i]->key, sn[j]->key);
+        if (r < 0) {
+            ret = false;
+            break;
+        }
+        int je = group_end(sn, nn, j);
+        int ie = r ? i : group_end(so, no, i);
+        if (r > 0 || !same_group(so, i, ie, sn, j, je)) {
+            for (;j<je;j++) send[sn[j]->index] = true;
+        }
+        i = ie;
+        j = je;
+    }
+    free(so);
+    free(sn);
+    return ret;
+}
+
+// never blocks, a preview which doesn't read gets a full description later
+static bool live_preview_send(XUiLivePreview *lp, const char *data, size_t size) {
+    while (size) {
+        ssize_t r = send(lp->fd, data, size, MSG_NOSIGNAL | MSG_DONTWAIT);
+        if (r < 0 && errno == EINTR) continue;
+        if (r <= 0) return false;
+        data += r;
+        size -= r;
+    }
+    return true;
+}
+
+// the designer state as the preview would show it
+static char *live_preview_text(XUiDesigner *designer, size_t *size) {
+    XUiString out;
+    xstring_init(&out);
+    print_preview(designer, &out);
+    return xstring_steal(&out, size);
+}
+
+static void live_preview_tick(void *data) {
+    XUiLivePreview *lp = (XUiLivePreview*)data;
+    lp->queued = false;
+    live_preview_sync(lp);
+}
+
+static void live_preview_queue(XUiLivePreview *lp, int ms) {
+    if (lp->queued) return;
+    lp->queued = true;
+    scheduler_timeout(lp->designer->scheduler, ms, live_preview_tick, lp);
+}
+
+void live_preview_changed(XUiLivePreview *lp) {
+    if (lp) live_preview_queue(lp, LIVE_PREVIEW_INTERVAL);
+}
+
+void live_preview_sync(XUiLivePreview *lp) {
+    size_t size = 0;
+    char *text = live_preview_text(lp->designer, &size);
+    if (!lp->resync && strcmp(text, lp->shown.text) == 0) {
+        free(text);
+        return;
+    }
+    LiveDescription now;
+    description_parse(&now, text);
+    bool *send = (bool*)calloc(now.lines+1, sizeof(bool));
+    bool ok = true;
+    if (!lp->resync && same_shape(&lp->shown, &now) && mark_changes(&lp->shown, &now, send)) {
+        XUiString diff;
+        xstring_init(&diff);
+        int i = 0;
+        for (;i<now.lines;i++) {
+            if (send[i]) xstring_printf(&diff, "%.*s\n", now.line[i].len, now.line[i].line);
+        }
+        if (diff.len) ok = live_preview_send(lp, diff.str, diff.len);
+        xstring_free(&diff);
+    } else if (lp->resync) {
+        // end a reload the preview may be in, the cut line before gets dropped
+        ok = live_preview_send(lp, "\nend\nreload\n", 12) && live_preview_send(lp, text, size) &&
+            live_preview_send(lp, "end\n", 4);
+    } else {
+        ok = live_preview_send(lp, "reload\n", 7) && live_preview_send(lp, text, size) &&
+            live_preview_send(lp, "end\n", 4);
+    }
+    free(send);
+    if (!ok) {
+        // the preview didn't get it, keep what it shows and try again later
+        description_free(&now);
+        lp->resync = true;
+        live_preview_queue(lp, LIVE_PREVIEW_RETRY);
+        return;
+    }
+    lp->resync = false;
+    description_free(&lp->shown);
+    lp->shown = now;
+}
+
+// the preview never writes, the socket turns readable when it's closed
+static void live_preview_hangup(int fd, void *data) {
+    XUiLivePreview *lp = (XUiLivePreview*)data;
+    char c;
+    if (read(fd, &c, 1) > 0) return;
+    lp->designer->live_preview = NULL;
+    live_preview_free(lp);
+}
+
+XUiLivePreview *live_preview_start(XUiDesigner *designer, const char *runtime) {
+    char name[] = "/tmp/xuipreview-XXXXXX";
+    size_t size = 0;
+    char *text = live_preview_text(designer, &size);
+    int tmp = mkstemp(name);
+    FILE *fp = tmp < 0 ? NULL : fdopen(tmp, "w");
+    if (!fp || fwrite(text, 1, size, fp) != size) {
+        if (fp) fclose(fp);
+        else if (tmp >= 0) close(tmp);
+        if (tmp >= 0) unlink(name);
+        fprintf(stderr,"open failed\n");
+        free(text);
+        return NULL;
+    }
+    fclose(fp);
+    int sv[2];
+    if (socketpair(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0, sv) < 0) {
+        unlink(name);
+        free(text);
+        return NULL;
+    }
+    pid_t pid = fork();
+    if (pid == 0) {
+        dup2(sv[1], STDIN_FILENO);
+        execl(runtime, runtime, "--live", name, (char*)NULL);
+        _exit(127);
+    }
+    close(sv[1]);
+    if (pid < 0) {
+        close(sv[0]);
+        unlink(name);
+        free(text);
+        return NULL;
+    }
+    XUiLivePreview *lp = (XUiLivePreview*)calloc(1, sizeof(XUiLivePreview));
+    lp->designer = designer;
+    lp->pid = pid;
+    lp->fd = sv[0];
+    lp->path = strdup(name);
+    description_parse(&lp->shown, text);
+    scheduler_watch_fd(designer->scheduler, lp->fd, live_preview_hangup, lp);
+    return lp;
+}
+
+void live_preview_free(XUiLivePreview *lp) {
+    if (!lp) return;
+    scheduler_cancel(lp->designer->scheduler, live_preview_tick, lp);
+    scheduler_unwatch_fd(lp->designer->scheduler, lp->fd);
+    close(lp->fd);
+    kill(lp->pid, SIGTERM);
+    waitpid(lp->pid, NULL, 0);
+    unlink(lp->path);
+    free(lp->path);
+    description_free(&lp->shown);
+    free(lp);
+}
@@ -772,9 +772,7 @@ int load_plugin_ui(Widget_t *w) {
         box_entry_set_text(designer->controller_label, designer->active_widget->label);
 
     if (!designer->ttlfile_view) create_text_view_window(designer);
-    XWindowAttributes attrs;
-    XGetWindowAttributes(designer->ttlfile_view->app->dpy, (Window)designer->ttlfile_view->widget, &attrs);
-    if (attrs.map_state == IsViewable) {
+    if (designer->ttlfile_view_mapped) {
         run_generate_ttl(designer->ttlfile, NULL);
     }
     XResizeWindow(designer->ui->app->dpy, designer->ui->widget, designer->ui->width, designer->ui->height+1);
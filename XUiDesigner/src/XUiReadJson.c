@@ -541,8 +541,7 @@ void read_json(XUiDesigner *designer, const char *filename) {
     designer->is_json_file = true;
     designer->is_project = false;
     XResizeWindow(designer->ui->app->dpy, designer->ui->widget, designer->ui->width, designer->ui->height-1);
-    pthread_t rf;
-    pthread_create(&rf, NULL, reset_flag, (void *)designer);
+    reset_fast_redraw(designer);
     if (fclose(fp)) {
         printf("Command not found or exited with error status\n");
         free(tmp);
@@ -0,0 +1,219 @@
+/*
+ *                           0BSD 
+ * 
+ *                    BSD Zero Clause License
+ * 
+ *  Copyright (c) 2021 Hermann Meyer
+ *
+ * Permission to use, copy, modify, and/or distribute this software for any
+ * purpose with or without fee is hereby granted.
+
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES WITH
+ * REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY
+ * AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT,
+ * INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM
+ * LOSS OF USE, DATA OR PROFITS, WHETHER IN AN ACTION OF CONTRACT, NEGLIGENCE OR
+ * OTHER TORTIOUS ACTION, ARISING OUT OF OR IN CONNECTION WITH THE USE OR
+ * PERFORMANCE OF THIS SOFTWARE.
+ *
+ */
+
+
+#include <poll.h>
+#include <time.h>
+
+#include "XUiScheduler.h"
+
+
+/*---------------------------------------------------------------------
+-----------------------------------------------------------------------    
+                timers and redraw batching on the UI thread
+-----------------------------------------------------------------------
+----------------------------------------------------------------------*/
+
+#define MAX_TIMERS 32
+#define MAX_REDRAWS 64
+#define MAX_WATCHES 8
+
+typedef struct {
+    scheduler_func func;
+    void *data;
+    long long deadline;
+    bool active;
+} Timer;
+
+typedef struct {
+    int fd;
+    scheduler_fd_func func;
+    void *data;
+} Watch;
+
+struct XUiScheduler {
+    Xputty *app;
+    Window main_window;
+    Atom wm_delete_window;
+    Timer timer[MAX_TIMERS];
+    Widget_t *redraw[MAX_REDRAWS];
+    int redraws;
+    Watch watch[MAX_WATCHES];
+    int watches;
+};
+
+static long long now_ms(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (long long)ts.tv_sec * 1000 + ts.tv_nsec / 1000000;
+}
+
+XUiScheduler *scheduler_new(Xputty *app, Window main_window) {
+    XUiScheduler *sched = (XUiScheduler*)malloc(sizeof(XUiScheduler));
+    sched->app = app;
+    sched->main_window = main_window;
+    sched->wm_delete_window = XInternAtom(app->dpy, "WM_DELETE_WINDOW", True);
+    int i = 0;
+    for (;i<MAX_TIMERS;i++) {
+        sched->timer[i].active = false;
+    }
+    sched->redraws = 0;
+    sched->watches = 0;
+    return sched;
+}
+
+void scheduler_free(XUiScheduler *sched) {
+    free(sched);
+}
+
+void scheduler_timeout(XUiScheduler *sched, int msec, scheduler_func func, void *data) {
+    int free_slot = -1;
+    int i = 0;
+    for (;i<MAX_TIMERS;i++) {
+        Timer *t = &sched->timer[i];
+        if (t->active && t->func == func && t->data == data) {
+            // restart a pending timer, so bursts of requests run once
+            t->deadline = now_ms() + msec;
+            return;
+        }
+        if (!t->active && free_slot < 0) free_slot = i;
+    }
+    if (free_slot < 0) {
+        fprintf(stderr, "scheduler: no free timer slot, run now\n");
+        func(data);
+        return;
+    }
+    sched->timer[free_slot].func = func;
+    sched->timer[free_slot].data = data;
+    sched->timer[free_slot].deadline = now_ms() + msec;
+    sched->timer[free_slot].active = true;
+}
+
+void scheduler_cancel(XUiScheduler *sched, scheduler_func func, void *data) {
+    int i = 0;
+    for (;i<MAX_TIMERS;i++) {
+        Timer *t = &sched->timer[i];
+        if (t->active && t->func == func && t->data == data) t->active = false;
+    }
+}
+
+void scheduler_queue_redraw(XUiScheduler *sched, Widget_t *w) {
+    int i = 0;
+    for (;i<sched->redraws;i++) {
+        if (sched->redraw[i] == w) return;
+    }
+    if (sched->redraws == MAX_REDRAWS) {
+        expose_widget(w);
+        return;
+    }
+    sched->redraw[sched->redraws++] = w;
+}
+
+void scheduler_watch_fd(XUiScheduler *sched, int fd, scheduler_fd_func func, void *data) {
+    if (sched->watches == MAX_WATCHES) {
+        fprintf(stderr, "scheduler: no free watch slot for fd %i\n", fd);
+        return;
+    }
+    sched->watch[sched->watches].fd = fd;
+    sched->watch[sched->watches].func = func;
+    sched->watch[sched->watches].data = data;
+    sched->watches++;
+}
+
+void scheduler_unwatch_fd(XUiScheduler *sched, int fd) {
+    int i = 0;
+    for (;i<sched->watches;i++) {
+        if (sched->watch[i].fd == fd) {
+            sched->watch[i] = sched->watch[--sched->watches];
+            return;
+        }
+    }
+}
+
+static int next_timeout(XUiScheduler *sched) {
+    if (sched->redraws) return 0;
+    long long next = -1;
+    int i = 0;
+    for (;i<MAX_TIMERS;i++) {
+        if (sched->timer[i].active && (next < 0 || sched->timer[i].deadline < next))
+            next = sched->timer[i].deadline;
+    }
+    if (next < 0) return -1;
+    return (int)max(0, next - now_ms());
+}
+
+static void run_timers(XUiScheduler *sched) {
+    long long now = now_ms();
+    int i = 0;
+    for (;i<MAX_TIMERS;i++) {
+        Timer *t = &sched->timer[i];
+        if (t->active && t->deadline <= now) {
+            // a callback may schedule itself again
+            t->active = false;
+            t->func(t->data);
+        }
+    }
+}
+
+static void run_redraws(XUiScheduler *sched) {
+    int redraws = sched->redraws;
+    sched->redraws = 0;
+    int i = 0;
+    for (;i<redraws;i++) {
+        expose_widget(sched->redraw[i]);
+    }
+}
+
+static Bool is_main_window_delete(Display *dpy, XEvent *xev, XPointer arg) {
+    XUiScheduler *sched = (XUiScheduler*)arg;
+    return xev->type == ClientMessage && xev->xclient.window == sched->main_window &&
+        (Atom)xev->xclient.data.l[0] == sched->wm_delete_window;
+}
+
+// replaces main_run(), events get dispatched by run_embedded() between the timers
+void scheduler_run(XUiScheduler *sched) {
+    Display *dpy = sched->app->dpy;
+    XSetWMProtocols(dpy, sched->main_window, &sched->wm_delete_window, 1);
+    struct pollfd fds[MAX_WATCHES+1];
+    XEvent xev;
+    while (sched->app->run) {
+        fds[0].fd = ConnectionNumber(dpy);
+        fds[0].events = POLLIN;
+        int n = sched->watches;
+        int i = 0;
+        for (;i<n;i++) {
+            fds[i+1].fd = sched->watch[i].fd;
+            fds[i+1].events = POLLIN;
+            fds[i+1].revents = 0;
+        }
+        poll(fds, n+1, XPending(dpy) ? 0 : next_timeout(sched));
+        for (i=n;i>0;i--) {
+            if (fds[i].revents && i-1 < sched->watches && sched->watch[i-1].fd == fds[i].fd)
+                sched->watch[i-1].func(fds[i].fd, sched->watch[i-1].data);
+        }
+        if (XCheckIfEvent(dpy, &xev, is_main_window_delete, (XPointer)sched)) {
+            sched->app->run = false;
+            break;
+        }
+        run_embedded(sched->app);
+        run_timers(sched);
+        run_redraws(sched);
+    }
+}
@@ -33,6 +33,7 @@ static void set_project_title(void *w_, void* UNUSED(user_data)) {
     if (strlen(text_box->input_label)>1) {
         widget_set_title(designer->ui,text_box->input_label);
         expose_widget(designer->ui);
+        designer_changed(designer);
     }
 }
 
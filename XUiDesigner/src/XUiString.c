@@ -0,0 +1,111 @@
+/*
+ *                           0BSD 
+ * 
+ *                    BSD Zero Clause License
+ * 
+ *  Copyright (c) 2021 Hermann Meyer
+ *
+ * Permission to use, copy, modify, and/or distribute this software for any
+ * purpose with or without fee is hereby granted.
+
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES WITH
+ * REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY
+ * AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT,
+ * INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM
+ * LOSS OF USE, DATA OR PROFITS, WHETHER IN AN ACTION OF CONTRACT, NEGLIGENCE OR
+ * OTHER TORTIOUS ACTION, ARISING OUT OF OR IN CONNECTION WITH THE USE OR
+ * PERFORMANCE OF THIS SOFTWARE.
+ *
+ */
+
+
+#include <stdarg.h>
+
+#include "XUiString.h"
+
+
+/*---------------------------------------------------------------------
+-----------------------------------------------------------------------    
+                growable text buffer for the generators
+-----------------------------------------------------------------------
+----------------------------------------------------------------------*/
+
+void xstring_init(XUiString *s) {
+    s->str = NULL;
+    s->len = 0;
+    s->size = 0;
+}
+
+void xstring_free(XUiString *s) {
+    free(s->str);
+    xstring_init(s);
+}
+
+void xstring_reset(XUiString *s) {
+    s->len = 0;
+    if (s->str) s->str[0] = '\0';
+}
+
+static void xstring_reserve(XUiString *s, size_t len) {
+    if (s->len + len + 1 <= s->size) return;
+    size_t size = s->size ? s->size : 4096;
+    while (size < s->len + len + 1) size *= 2;
+    s->str = (char*)realloc(s->str, size);
+    s->size = size;
+}
+
+void xstring_append_len(XUiString *s, const char *str, size_t len) {
+    xstring_reserve(s, len);
+    memcpy(s->str + s->len, str, len);
+    s->len += len;
+    s->str[s->len] = '\0';
+}
+
+void xstring_append(XUiString *s, const char *str) {
+    xstring_append_len(s, str, strlen(str));
+}
+
+void xstring_printf(XUiString *s, const char *fmt, ...) {
+    va_list args;
+    va_start(args, fmt);
+    size_t room = s->size - s->len;
+    int len = vsnprintf(s->size ? s->str + s->len : NULL, room, fmt, args);
+    va_end(args);
+    if (len < 0) return;
+    if ((size_t)len >= room) {
+        xstring_reserve(s, len);
+        va_start(args, fmt);
+        vsnprintf(s->str + s->len, len + 1, fmt, args);
+        va_end(args);
+    }
+    s->len += len;
+}
+
+// hand the text over to the caller, the buffer is empty afterwards
+char *xstring_steal(XUiString *s, size_t *len) {
+    char *str = s->str;
+    if (len) *len = s->len;
+    if (!str) str = strdup("");
+    xstring_init(s);
+    return str;
+}
+
+int xstring_write_file(XUiString *s, const char *filename) {
+    FILE *fp = fopen(filename, "w");
+    if (fp == NULL) return -1;
+    size_t written = s->len ? fwrite(s->str, 1, s->len, fp) : 0;
+    int ret = fclose(fp);
+    return (written == s->len && !ret) ? 0 : -1;
+}
+
+// 64 bit FNV-1a, good enough to tell if generated content changed
+uint64_t hash_data(const void *data, size_t len) {
+    const unsigned char *p = (const unsigned char*)data;
+    uint64_t hash = 0xcbf29ce484222325ULL;
+    size_t i = 0;
+    for (;i<len;i++) {
+        hash ^= p[i];
+        hash *= 0x100000001b3ULL;
+    }
+    return hash;
+}
@@ -17,65 +17,162 @@
  * PERFORMANCE OF THIS SOFTWARE.
  *
  */
-
 #include "XUiTurtleView.h"
 #include "XUiWriteTurtle.h"
+#include "XUiWriteUI.h"
+#include "XUiWritePlugin.h"
+#include "XUiWriteJson.h"
+#include "XUiScheduler.h"
+#include "XUiGenerator.h"
 
 
 /*---------------------------------------------------------------------
 -----------------------------------------------------------------------    
-                show generated ttl file for loaded plugin
+                show generated files for loaded plugin
 -----------------------------------------------------------------------
 ----------------------------------------------------------------------*/
 
+// generated text kept in memory, newlines replaced by '\0' so each line is a string
+typedef struct {
+    char *text;
+    size_t size;
+    size_t *line;
+    int lines;
+    int changed_first;
+    int changed_last;
+    bool dirty;
+    generate_func generate;
+} TextBuffer;
+
+static void generate_json(XUiDesigner *designer, XUiString *out) {
+    print_json(designer, ".", out);
+}
+
+static const char *tab_names[] = {"TTL", "C", "C++", "JSON"};
+
+static generate_func tab_generators[] = {print_ttl, print_list, print_plugin, generate_json};
+
+static double line_height(Widget_t *w) {
+    return (w->app->normal_font/w->scale.ascale) + 6;
+}
+
+// replace the text, re-index only the lines between the common head and tail
+static void text_buffer_set(TextBuffer *tb, char *text, size_t size) {
+    size_t i = 0;
+    for (;i<size;i++) {
+        if (text[i] == '\n') text[i] = '\0';
+    }
+    size_t old_size = tb->size;
+    size_t common = min(old_size, size);
+    size_t head = 0;
+    while (head < common && tb->text[head] == text[head]) head++;
+    if (head == size && size == old_size) {
+        free(text);
+        tb->changed_first = tb->changed_last = 0;
+        return;
+    }
+    size_t tail = 0;
+    while (tail < common - head && tb->text[old_size-tail-1] == text[size-tail-1]) tail++;
+
+    // lines starting inside the common head stay as they are
+    int first = 0;
+    while (first < tb->lines && tb->line[first] <= head) first++;
+    first = max(0, first-1);
+    // lines starting inside the common tail only move
+    int keep = tb->lines;
+    while (keep > first+1 && tb->line[keep-1] > old_size-tail) keep--;
+    int moved = tb->lines - keep;
+
+    int changed = 0;
+    size_t start = first < tb->lines ? tb->line[first] : 0;
+    for (i=start;i<size-tail;i++) {
+        if (text[i] == '\0' && i+1 < size) changed++;
+    }
+    size_t *line = (size_t*)malloc((first + 1 + changed + moved + 1) * sizeof(size_t));
+    if (first) memcpy(line, tb->line, first * sizeof(size_t));
+    int l = first;
+    line[l++] = start;
+    for (i=start;i<size-tail;i++) {
+        if (text[i] == '\0' && i+1 < size) line[l++] = i+1;
+    }
+    int changed_last = l;
+    int k = keep;
+    for (;k<tb->lines;k++) {
+        line[l++] = tb->line[k] - old_size + size;
+    }
+    if (!size) l = 0;
+    free(tb->text);
+    free(tb->line);
+    tb->text = text;
+    tb->size = size;
+    tb->line = line;
+    tb->lines = l;
+    tb->changed_first = first;
+    tb->changed_last = changed_last;
+}
+
+static void text_buffer_mem_free(void *w_, void* UNUSED(user_data)) {
+    Widget_t *w = (Widget_t*)w_;
+    TextBuffer *tb = (TextBuffer*)w->private_struct;
+    free(tb->text);
+    free(tb->line);
+    free(tb);
+}
+
 static void adjust_viewport(void *w_, void* UNUSED(user_data)) {
     Widget_t *parent = (Widget_t*)w_;
     Widget_t *w = parent->childlist->childs[1];
+    TextBuffer *tb = (TextBuffer*)w->private_struct;
     XWindowAttributes attrs;
     XGetWindowAttributes(parent->app->dpy, (Window)parent->widget, &attrs);
     int height_t = attrs.height;
-    XGetWindowAttributes(parent->app->dpy, (Window)w->widget, &attrs);
-    int height = attrs.height;
-    float d = (float)height/(float)height_t;
-    float max_value = (float)((float)height/((float)(height_t/(float)(height-height_t))*(d*10.0)));
+    if (w->height != height_t) XResizeWindow(w->app->dpy, w->widget, w->width, height_t);
+    int visible = (int)(height_t/line_height(w));
+    float max_value = (float)max(0, tb->lines - visible + 1);
     float value = adj_get_value(w->adj);
     w->adj_y->max_value = max_value;
-    if (max_value < value) adj_set_value(w->adj,value);
+    if (max_value < value) adj_set_value(w->adj,max_value);
+}
+
+// regenerate the text when it is shown, so only the visible tab does the work
+static void update_text_view(Widget_t *w) {
+    XUiDesigner *designer = (XUiDesigner*)w->parent_struct;
+    TextBuffer *tb = (TextBuffer*)w->private_struct;
+    size_t size = 0;
+    char *text = generate_text(designer, tb->generate, &size);
+    tb->dirty = false;
+    if (!text) return;
+    text_buffer_set(tb, text, size);
+    adjust_viewport(w->parent, NULL);
 }
 
 static void draw_ttlview(void *w_, void* UNUSED(user_data)) {
     Widget_t *w = (Widget_t*)w_;
-    Widget_t *p = (Widget_t*)w->parent;
-    FILE *fp;
-    if ((fp=fopen("/tmp/xui.ttl", "r"))==NULL) {
-        printf("open failed\n");
-        return;
-    }
-    int i = 1;
-    char buf[200];
-    while(fgets(buf,sizeof(buf),fp) != NULL) {
-        i++;
-    }
-    fseek(fp, 0, SEEK_SET);
-    XResizeWindow(w->app->dpy, w->widget, w->width, (w->app->normal_font/w->scale.ascale) * i + 6 * i + 10);
-    adjust_viewport(p, NULL);
+    TextBuffer *tb = (TextBuffer*)w->private_struct;
+    if (tb->dirty) update_text_view(w);
 
     cairo_set_source_rgba(w->crb,  0.13, 0.13, 0.13, 1.0);
     cairo_paint (w->crb);
+    if (!tb->lines) return;
 
-    i = 1;
+    double lh = line_height(w);
+    int first = (int)max(0,adj_get_value(w->adj));
+    int last = min(tb->lines, first + (int)(w->height/lh) + 1);
+    int mark_first = max(first, tb->changed_first);
+    int mark_last = min(last, tb->changed_last);
+    if (mark_first < mark_last) {
+        cairo_set_source_rgba(w->crb,  0.2, 0.2, 0.26, 1.0);
+        cairo_rectangle(w->crb, 0, lh * (mark_first-first) + 4, w->width, lh * (mark_last-mark_first));
+        cairo_fill(w->crb);
+    }
     use_text_color_scheme(w, get_color_state(w));
     cairo_set_font_size (w->crb, w->app->normal_font/w->scale.ascale);
 
-    while(fgets(buf,sizeof(buf),fp) != NULL) {
-        strdecode(buf, "\n", "");
-        cairo_move_to (w->crb, 10, (w->app->normal_font/w->scale.ascale) * i + 6 * i);
-        cairo_show_text(w->crb, buf);
-        i++;
+    int i = first;
+    for (;i<last;i++) {
+        cairo_move_to (w->crb, 10, lh * (i-first+1));
+        cairo_show_text(w->crb, tb->text + tb->line[i]);
     }
-    fclose(fp);
-    fp = NULL;
-    
 }
 
 static void draw_viewslider(void *w_, void* UNUSED(user_data)) {
@@ -103,8 +200,7 @@ static void set_viewpoint(void *w_, void* UNUSED(user_data)) {
     Widget_t *p = (Widget_t*)w->parent;
     Widget_t *slider = p->childlist->childs[0];
     adj_set_state(slider->adj, adj_get_state(w->adj));
-    int v = (int)max(0,adj_get_value(w->adj));
-    XMoveWindow(w->app->dpy,w->widget,0, -10*v);
+    expose_widget(w);
 }
 
 static void set_viewport(void *w_, void* UNUSED(user_data)) {
@@ -114,7 +210,8 @@ static void set_viewport(void *w_, void* UNUSED(user_data)) {
     adj_set_state(viewport->adj, adj_get_state(w->adj));
 }
 
-static Widget_t* add_viewport(Widget_t *parent, int width, int height) {
+static Widget_t* add_viewport(Widget_t *parent, XUiDesigner *designer, generate_func generate,
+                                                                    int width, int height) {
     Widget_t *slider = add_vslider(parent, "", width, 0, 10, height);
     slider->func.expose_callback = draw_viewslider;
     slider->adj_y = add_adjustment(slider,0.0, 0.0, 0.0, 1.0,0.0085, CL_VIEWPORTSLIDER);
@@ -128,17 +225,22 @@ static Widget_t* add_viewport(Widget_t *parent, int width, int height) {
     XSelectInput(wid->app->dpy, wid->widget,StructureNotifyMask|ExposureMask|KeyPressMask 
                     |EnterWindowMask|LeaveWindowMask|ButtonReleaseMask|KeyReleaseMask
                     |ButtonPressMask|Button1MotionMask|PointerMotionMask);
-    Widget_t *p = (Widget_t*)parent->parent;
-    wid->parent_struct = p->parent_struct;
+    wid->parent_struct = designer;
     wid->scale.gravity = NONE;
     wid->flags &= ~USE_TRANSPARENCY;
-    wid->flags |= NO_AUTOREPEAT | NO_PROPAGATE;
-    XWindowAttributes attrs;
-    XGetWindowAttributes(parent->app->dpy, (Window)parent->widget, &attrs);
-    int height_t = attrs.height;
-    float d = (float)height/(float)height_t;
-    float max_value = (float)((float)height/((float)(height_t/(float)(height-height_t))*(d*10.0)));
-    wid->adj_y = add_adjustment(wid,0.0, 0.0, 0.0,max_value ,3.0, CL_VIEWPORT);
+    wid->flags |= NO_AUTOREPEAT | NO_PROPAGATE | HAS_MEM;
+    TextBuffer *tb = (TextBuffer*)malloc(sizeof(TextBuffer));
+    tb->text = NULL;
+    tb->size = 0;
+    tb->line = NULL;
+    tb->lines = 0;
+    tb->changed_first = 0;
+    tb->changed_last = 0;
+    tb->dirty = true;
+    tb->generate = generate;
+    wid->private_struct = tb;
+    wid->func.mem_free_callback = text_buffer_mem_free;
+    wid->adj_y = add_adjustment(wid,0.0, 0.0, 0.0, 0.0, 3.0, CL_VIEWPORT);
     wid->adj = wid->adj_y;
     wid->func.adj_callback = set_viewpoint;
     wid->func.expose_callback = draw_ttlview;
@@ -149,6 +251,25 @@ static Widget_t* add_viewport(Widget_t *parent, int width, int height) {
     return wid;
 }
 
+static Widget_t *get_viewport(XUiDesigner *designer, int tab) {
+    Widget_t *tabbox = designer->ttlfile_view->childlist->childs[0];
+    Widget_t *wi = tabbox->childlist->childs[tab];
+    return wi->childlist->childs[1];
+}
+
+// keep track of the map state, so change notifications don't need a server round-trip
+static void text_view_mapped(void *w_, void* UNUSED(user_data)) {
+    Widget_t *w = (Widget_t*)w_;
+    XUiDesigner *designer = (XUiDesigner*)w->parent_struct;
+    designer->ttlfile_view_mapped = true;
+}
+
+static void text_view_unmapped(void *w_, void* UNUSED(user_data)) {
+    Widget_t *w = (Widget_t*)w_;
+    XUiDesigner *designer = (XUiDesigner*)w->parent_struct;
+    designer->ttlfile_view_mapped = false;
+}
+
 void create_text_view_window(XUiDesigner *designer) {
     Atom wmStateAbove = XInternAtom(designer->w->app->dpy, "_NET_WM_STATE_ABOVE", 1 );
     Atom wmNetWmState = XInternAtom(designer->w->app->dpy, "_NET_WM_STATE", 1 );
@@ -159,10 +280,31 @@ void create_text_view_window(XUiDesigner *designer) {
     //XSetTransientForHint(designer->w->app->dpy, w->widget, designer->ui->widget);
     //designer->set_project->func.expose_callback = draw_text_window;
     designer->ttlfile_view->flags |= HIDE_ON_DELETE;
-    widget_set_title(designer->ttlfile_view, _("ttl"));
+    widget_set_title(designer->ttlfile_view, _("Generated Files"));
     widget_set_icon_from_png(designer->ttlfile_view, LDVAR(file_png));
+    designer->ttlfile_view->parent_struct = designer;
+    designer->ttlfile_view->func.map_notify_callback = text_view_mapped;
+    designer->ttlfile_view->func.unmap_notify_callback = text_view_unmapped;
+
+    Widget_t *tabbox = add_tabbox(designer->ttlfile_view, "", 0, 0, 620, 800);
+    int i = 0;
+    for (;i<PREVIEW_TABS;i++) {
+        Widget_t *tab = tabbox_add_tab(tabbox, tab_names[i]);
+        add_viewport(tab, designer, tab_generators[i], tab->width-10, tab->height);
+    }
+}
 
-    add_viewport(designer->ttlfile_view, 610, 800);
+void preview_notify_changed(XUiDesigner *designer) {
+    if (!designer->ttlfile_view) return;
+    int i = 0;
+    for (;i<PREVIEW_TABS;i++) {
+        Widget_t *viewport = get_viewport(designer, i);
+        TextBuffer *tb = (TextBuffer*)viewport->private_struct;
+        tb->dirty = true;
+    }
+    if (!designer->ttlfile_view_mapped) return;
+    Widget_t *tabbox = designer->ttlfile_view->childlist->childs[0];
+    scheduler_queue_redraw(designer->scheduler, get_viewport(designer, (int)adj_get_value(tabbox->adj)));
 }
 
 void run_generate_ttl(void *w_, void* UNUSED(user_data)) {
@@ -171,24 +313,9 @@ void run_generate_ttl(void *w_, void* UNUSED(user_data)) {
         XUiDesigner *designer = (XUiDesigner*)w->parent_struct;
         if (!designer->ttlfile_view) create_text_view_window(designer);
 
-        FILE *fp;
-        if((fp=freopen("/tmp/xui.ttl", "w" ,stdout))==NULL) {
-            printf("open failed\n");
-            return;
-        }
-
-        print_ttl(designer);
-
-        fclose(fp);
-        fp = NULL;
-        XWindowAttributes attrs;
-        XGetWindowAttributes(w->app->dpy, (Window)designer->ttlfile_view->widget, &attrs);
-        if (attrs.map_state != IsViewable) {
+        if (!designer->ttlfile_view_mapped) {
             widget_show_all(designer->ttlfile_view);
-        } else {
-            Widget_t *viewport = designer->ttlfile_view->childlist->childs[1];
-            expose_widget(viewport);
         }
-
+        preview_notify_changed(designer);
     }
 }
@@ -32,8 +32,12 @@
 #include "XUiImageLoader.h"
 #include "XUiControllerType.h"
 
-bool need_comma = false;
-bool need_tab = false;
+// output buffer and separator state of the json writer
+typedef struct {
+    XUiString *out;
+    bool need_comma;
+    bool need_tab;
+} JsonWriter;
 
 static double *get_selected_color(Colors *c, int s) {
     double *use = NULL;
@@ -58,9 +62,9 @@ static double *get_selected_color(Colors *c, int s) {
     return use;
 }
 
-static void print_colors(XUiDesigner *designer) {
+static void print_colors(XUiDesigner *designer, JsonWriter *js) {
     Colors *c = &designer->ui->color_scheme->normal;
-    printf (
+    xstring_printf(js->out,
     "      \"NORMAL\" : [\n"
     "        \".fg\" :       [ %.3f, %.3f, %.3f, %.3f] ,\n"
     "        \".bg\" :       [ %.3f, %.3f, %.3f, %.3f] ,\n"
@@ -79,7 +83,7 @@ static void print_colors(XUiDesigner *designer) {
                 c->light[0],c->light[1],c->light[2],c->light[3]);
 
     c = &designer->ui->color_scheme->prelight;
-    printf (
+    xstring_printf(js->out,
     "      \"PRELIGHT\" : [\n"
     "        \".fg\" :       [ %.3f, %.3f, %.3f, %.3f] ,\n"
     "        \".bg\" :       [ %.3f, %.3f, %.3f, %.3f] ,\n"
@@ -98,7 +102,7 @@ static void print_colors(XUiDesigner *designer) {
                 c->light[0],c->light[1],c->light[2],c->light[3]);
 
     c = &designer->ui->color_scheme->selected;
-    printf (
+    xstring_printf(js->out,
     "      \"SELECTED\" : [\n"
     "        \".fg\" :       [ %.3f, %.3f, %.3f, %.3f] ,\n"
     "        \".bg\" :       [ %.3f, %.3f, %.3f, %.3f] ,\n"
@@ -117,7 +121,7 @@ static void print_colors(XUiDesigner *designer) {
                 c->light[0],c->light[1],c->light[2],c->light[3]);
 
     c = &designer->ui->color_scheme->active;
-    printf (
+    xstring_printf(js->out,
     "      \"ACTIVE\" : [\n"
     "        \".fg\" :       [ %.3f, %.3f, %.3f, %.3f] ,\n"
     "        \".bg\" :       [ %.3f, %.3f, %.3f, %.3f] ,\n"
@@ -136,7 +140,7 @@ static void print_colors(XUiDesigner *designer) {
                 c->light[0],c->light[1],c->light[2],c->light[3]);
 
     c = &designer->ui->color_scheme->insensitive;
-    printf (
+    xstring_printf(js->out,
     "      \"INSENSITIVE\" : [\n"
     "        \".fg\" :       [ %.3f, %.3f, %.3f, %.3f] ,\n"
     "        \".bg\" :       [ %.3f, %.3f, %.3f, %.3f] ,\n"
@@ -218,57 +222,57 @@ static const char* parse_type(WidgetType is_type) {
     } 
 }
 
-static void json_start_object (char *s) {
-    printf ("{\n  \"%s\" :", s);
-    need_comma = false;
+static void json_start_object(JsonWriter *js, char *s) {
+    xstring_printf(js->out, "{\n  \"%s\" :", s);
+    js->need_comma = false;
 }
 
-static void json_start_array(void) {
-    printf (" [");
-    need_comma = false;
+static void json_start_array(JsonWriter *js) {
+    xstring_printf(js->out, " [");
+    js->need_comma = false;
 }
 
-static void json_close_array(void) {
-    printf ("] ");
-    need_comma = true;
+static void json_close_array(JsonWriter *js) {
+    xstring_printf(js->out, "] ");
+    js->need_comma = true;
 }
 
-static void json_start_value_pair(void) {
-    printf ("\n    {\n");
-    need_tab = true;
+static void json_start_value_pair(JsonWriter *js) {
+    xstring_printf(js->out, "\n    {\n");
+    js->need_tab = true;
 }
 
-static void json_close_value_pair(void) {
-    printf (",\n    }\n  ");
-    need_tab = false;
+static void json_close_value_pair(JsonWriter *js) {
+    xstring_printf(js->out, ",\n    }\n  ");
+    js->need_tab = false;
 }
 
-static void json_add_int(int i) {
-    printf ("%s %i ", need_comma ? "," : "", i);
-    need_comma = true;
+static void json_add_int(JsonWriter *js, int i) {
+    xstring_printf(js->out, "%s %i ", js->need_comma ? "," : "", i);
+    js->need_comma = true;
 }
 
-static void json_add_float(float f) {
-    printf ("%s %f ", need_comma ? "," : "", f);
-    need_comma = true;
+static void json_add_float(JsonWriter *js, float f) {
+    xstring_printf(js->out, "%s %f ", js->need_comma ? "," : "", f);
+    js->need_comma = true;
 }
 
-static void json_add_string(const char* s) {
-    printf ("%s \"%s\"", need_comma ? "," : "", s);
-    need_comma = true;
+static void json_add_string(JsonWriter *js, const char* s) {
+    xstring_printf(js->out, "%s \"%s\"", js->need_comma ? "," : "", s);
+    js->need_comma = true;
 }
 
-static void json_add_key(const char* s) {
-    printf ("%s%s  \"%s\" :", need_comma ? ",\n" : "", need_tab ? "    " : "", s);
-    need_comma = false;
+static void json_add_key(JsonWriter *js, const char* s) {
+    xstring_printf(js->out, "%s%s  \"%s\" :", js->need_comma ? ",\n" : "", js->need_tab ? "    " : "", s);
+    js->need_comma = false;
 }
 
-static void json_close_object(void) {
-    printf ("\n}\n");
-    need_comma = false;
+static void json_close_object(JsonWriter *js) {
+    xstring_printf(js->out, "\n}\n");
+    js->need_comma = false;
 }
 
-static void check_for_Widget_color(XUiDesigner *designer, Widget_t * wid) {
+static void check_for_Widget_color(XUiDesigner *designer, Widget_t * wid, JsonWriter *js) {
     int j = 0;  // Color_state
     for(;j<5;j++) {
         int k = 0; // Color_mod
@@ -278,15 +282,15 @@ static void check_for_Widget_color(XUiDesigner *designer, Widget_t * wid) {
             double *b = get_selected_color(get_color_scheme(wid, j), k);
             a = memcmp(c, b, 4 * sizeof(double));
             if (a != 0) {
-                json_add_key ("COLOR");
-                json_start_array();
-                json_add_int(j);
-                json_add_int(k);
-                json_add_float(b[0]);
-                json_add_float(b[1]);
-                json_add_float(b[2]);
-                json_add_float(b[3]);
-                json_close_array();
+                json_add_key (js, "COLOR");
+                json_start_array(js);
+                json_add_int(js, j);
+                json_add_int(js, k);
+                json_add_float(js, b[0]);
+                json_add_float(js, b[1]);
+                json_add_float(js, b[2]);
+                json_add_float(js, b[3]);
+                json_close_array(js);
             }
         }
     }
@@ -311,7 +315,9 @@ char *set_resource_path(XUiDesigner *designer, const char* filepath, const char*
     return fxldl;
 }
 
-void print_json(XUiDesigner *designer, const char* filepath) {
+void print_json(XUiDesigner *designer, const char* filepath, XUiString *out) {
+    JsonWriter json = {out, false, false};
+    JsonWriter *js = &json;
     char *name = NULL;
     XFetchName(designer->ui->app->dpy, designer->ui->widget, &name);
     if (name == NULL) asprintf(&name, "%s", "noname");
@@ -347,182 +353,182 @@ void print_json(XUiDesigner *designer, const char* filepath) {
     if (designer->MIDIPORT > -1 && MIDI_PORT == -1) {
         MIDI_PORT = designer->MIDIPORT;
     }
-    json_start_object ("Project");
-    json_add_string(designer->lv2c.ui_uri);
+    json_start_object (js, "Project");
+    json_add_string(js, designer->lv2c.ui_uri);
 
-    json_add_key ("Name");
-    json_add_string(name);
+    json_add_key (js, "Name");
+    json_add_string(js, name);
 
-    json_add_key ("Author");
-    json_add_string(designer->lv2c.author);
+    json_add_key (js, "Author");
+    json_add_string(js, designer->lv2c.author);
 
-    json_add_key ("Window size");
-    json_start_array();
-    json_add_int(designer->ui->width);
-    json_add_int(designer->ui->height);
-    json_close_array();
+    json_add_key (js, "Window size");
+    json_start_array(js);
+    json_add_int(js, designer->ui->width);
+    json_add_int(js, designer->ui->height);
+    json_close_array(js);
 
     if (designer->image != NULL ) {
-        json_add_key ("Image");
+        json_add_key (js, "Image");
         char *image = set_resource_path(designer, filepath, designer->image);
-        json_add_string(image);
+        json_add_string(js, image);
         free(image);
     }
     
-    json_add_key ("Contolls");
-    json_add_int(j);
+    json_add_key (js, "Contolls");
+    json_add_int(js, j);
 
-    json_add_key ("Colors");
-    json_start_array();
-    json_start_value_pair();
-    print_colors(designer);
-    json_close_value_pair();
-    json_close_array();
+    json_add_key (js, "Colors");
+    json_start_array(js);
+    json_start_value_pair(js);
+    print_colors(designer, js);
+    json_close_value_pair(js);
+    json_close_array(js);
 
     i = 0;
     for (;i<MAX_CONTROLS;i++) {
         if (designer->controls[i].wid != NULL) {
             if (designer->controls[i].is_type == IS_FRAME) {
-                json_add_key ("IS_Frame Box");
-                json_start_array();
-                json_start_value_pair();
-                json_add_key ("Type");
-                json_add_string(designer->controls[i].type);
-                json_add_key ("Label");
-                json_add_string(designer->controls[i].wid->label);
-                json_add_key ("Size");
-                json_start_array();
-                json_add_int(designer->controls[i].wid->x);
-                json_add_int(designer->controls[i].wid->y);
-                json_add_int(designer->controls[i].wid->width);
-                json_add_int(designer->controls[i].wid->height);
-                json_close_array();
-                json_add_key ("Image");
+                json_add_key (js, "IS_Frame Box");
+                json_start_array(js);
+                json_start_value_pair(js);
+                json_add_key (js, "Type");
+                json_add_string(js, designer->controls[i].type);
+                json_add_key (js, "Label");
+                json_add_string(js, designer->controls[i].wid->label);
+                json_add_key (js, "Size");
+                json_start_array(js);
+                json_add_int(js, designer->controls[i].wid->x);
+                json_add_int(js, designer->controls[i].wid->y);
+                json_add_int(js, designer->controls[i].wid->width);
+                json_add_int(js, designer->controls[i].wid->height);
+                json_close_array(js);
+                json_add_key (js, "Image");
                 if (designer->controls[i].image != NULL ) {
-                    json_add_string(designer->controls[i].image);
+                    json_add_string(js, designer->controls[i].image);
                 } else {
-                    json_add_string("None");
+                    json_add_string(js, "None");
                 }
-                json_close_value_pair();
-                json_close_array();
-                check_for_Widget_color(designer, designer->controls[i].wid);
+                json_close_value_pair(js);
+                json_close_array(js);
+                check_for_Widget_color(designer, designer->controls[i].wid, js);
             } else if (designer->controls[i].is_type == IS_TABBOX) {
-                json_add_key ("IS_TAB Box");
-                json_start_array();
-                json_start_value_pair();
-                json_add_key ("Type");
-                json_add_string(designer->controls[i].type);
-                json_add_key ("Label");
-                json_add_string(designer->controls[i].wid->label);
-                json_add_key ("Size");
-                json_start_array();
-                json_add_int(designer->controls[i].wid->x);
-                json_add_int(designer->controls[i].wid->y);
-                json_add_int(designer->controls[i].wid->width);
-                json_add_int(designer->controls[i].wid->height);
-                json_close_array();
-                json_add_key ("Image");
+                json_add_key (js, "IS_TAB Box");
+                json_start_array(js);
+                json_start_value_pair(js);
+                json_add_key (js, "Type");
+                json_add_string(js, designer->controls[i].type);
+                json_add_key (js, "Label");
+                json_add_string(js, designer->controls[i].wid->label);
+                json_add_key (js, "Size");
+                json_start_array(js);
+                json_add_int(js, designer->controls[i].wid->x);
+                json_add_int(js, designer->controls[i].wid->y);
+                json_add_int(js, designer->controls[i].wid->width);
+                json_add_int(js, designer->controls[i].wid->height);
+                json_close_array(js);
+                json_add_key (js, "Image");
                 if (designer->controls[i].image != NULL ) {
-                    json_add_string(designer->controls[i].image);
+                    json_add_string(js, designer->controls[i].image);
                 } else {
-                    json_add_string("None");
+                    json_add_string(js, "None");
                 }
-                json_close_value_pair();
-                json_close_array();
+                json_close_value_pair(js);
+                json_close_array(js);
                 int elem = designer->controls[i].wid->childlist->elem;
                 if (elem) {
-                    json_add_key ("TAB Box item");
+                    json_add_key (js, "TAB Box item");
                 }
                 int t = 0;
                 for(;t<elem;t++) {
                     Widget_t *wi = designer->controls[i].wid->childlist->childs[t];
-                    json_start_array();
-                    json_start_value_pair();
-                    json_add_key ("Type");
-                    json_add_string("add_lv2_tab");
-                    json_add_key ("Label");
-                    json_add_string(wi->label);
-                    json_add_key ("Size");
-                    json_start_array();
-                    json_add_int(wi->x);
-                    json_add_int(wi->y);
-                    json_add_int(wi->width);
-                    json_add_int(wi->height);
-                    json_close_array();
-                    json_close_value_pair();
-                    json_close_array();
+                    json_start_array(js);
+                    json_start_value_pair(js);
+                    json_add_key (js, "Type");
+                    json_add_string(js, "add_lv2_tab");
+                    json_add_key (js, "Label");
+                    json_add_string(js, wi->label);
+                    json_add_key (js, "Size");
+                    json_start_array(js);
+                    json_add_int(js, wi->x);
+                    json_add_int(js, wi->y);
+                    json_add_int(js, wi->width);
+                    json_add_int(js, wi->height);
+                    json_close_array(js);
+                    json_close_value_pair(js);
+                    json_close_array(js);
                 }
-                check_for_Widget_color(designer, designer->controls[i].wid);
+                check_for_Widget_color(designer, designer->controls[i].wid, js);
             } else if (!designer->controls[i].is_audio_output && !designer->controls[i].is_audio_input &&
                 !designer->controls[i].is_atom_output && !designer->controls[i].is_atom_input) {
-                json_add_key (parse_type(designer->controls[i].is_type));
-                json_start_array();
-                json_start_value_pair();
-                json_add_key ("Type");
-                json_add_string(designer->controls[i].type);
-                json_add_key ("Label");
-                json_add_string(designer->controls[i].wid->label);
-                json_add_key ("Port");
-                json_add_int(designer->controls[i].port_index);
-                json_add_key ("Symbol");
-                json_add_string(designer->controls[i].symbol);
-                json_add_key ("Size");
-                json_start_array();
-                json_add_int(designer->controls[i].wid->x);
-                json_add_int(designer->controls[i].wid->y);
-                json_add_int(designer->controls[i].wid->width);
-                json_add_int(designer->controls[i].wid->height);
-                json_close_array();
-                json_add_key ("Image");
+                json_add_key (js, parse_type(designer->controls[i].is_type));
+                json_start_array(js);
+                json_start_value_pair(js);
+                json_add_key (js, "Type");
+                json_add_string(js, designer->controls[i].type);
+                json_add_key (js, "Label");
+                json_add_string(js, designer->controls[i].wid->label);
+                json_add_key (js, "Port");
+                json_add_int(js, designer->controls[i].port_index);
+                json_add_key (js, "Symbol");
+                json_add_string(js, designer->controls[i].symbol);
+                json_add_key (js, "Size");
+                json_start_array(js);
+                json_add_int(js, designer->controls[i].wid->x);
+                json_add_int(js, designer->controls[i].wid->y);
+                json_add_int(js, designer->controls[i].wid->width);
+                json_add_int(js, designer->controls[i].wid->height);
+                json_close_array(js);
+                json_add_key (js, "Image");
                 if (designer->controls[i].image != NULL ) {
                     char *image = set_resource_path(designer, filepath, designer->controls[i].image);
-                    json_add_string(image);
+                    json_add_string(js, image);
                     free(image);
                 } else {
-                    json_add_string("None");
+                    json_add_string(js, "None");
                 }
                 if (designer->controls[i].in_frame) {
-                    json_add_key ("Parent");
-                    json_start_array();
-                    json_add_int(designer->controls[i].in_frame-1);
-                    json_add_int(designer->controls[i].in_tab-1);
-                    json_close_array();
+                    json_add_key (js, "Parent");
+                    json_start_array(js);
+                    json_add_int(js, designer->controls[i].in_frame-1);
+                    json_add_int(js, designer->controls[i].in_tab-1);
+                    json_close_array(js);
                 }
                 
                 if (designer->controls[i].have_adjustment) {
-                    json_add_key ("Adjustment");
-                    json_add_string(parse_adjusment_type(designer->controls[i].wid->adj->type));
-                    json_add_key ("Default Value");
-                    json_add_float(adj_get_std_value(designer->controls[i].wid->adj));
-                    json_add_key ("Min Value");
-                    json_add_float(adj_get_min_value(designer->controls[i].wid->adj));
-                    json_add_key ("Max Value");
-                    json_add_float(adj_get_max_value(designer->controls[i].wid->adj));
-                    json_add_key ("Step Size");
-                    json_add_float(designer->controls[i].wid->adj->step);
+                    json_add_key (js, "Adjustment");
+                    json_add_string(js, parse_adjusment_type(designer->controls[i].wid->adj->type));
+                    json_add_key (js, "Default Value");
+                    json_add_float(js, adj_get_std_value(designer->controls[i].wid->adj));
+                    json_add_key (js, "Min Value");
+                    json_add_float(js, adj_get_min_value(designer->controls[i].wid->adj));
+                    json_add_key (js, "Max Value");
+                    json_add_float(js, adj_get_max_value(designer->controls[i].wid->adj));
+                    json_add_key (js, "Step Size");
+                    json_add_float(js, designer->controls[i].wid->adj->step);
                 }
                 if (designer->controls[i].is_type == IS_COMBOBOX) {
                     Widget_t *menu = designer->controls[i].wid->childlist->childs[1];
                     Widget_t* view_port =  menu->childlist->childs[0];
                     ComboBox_t *comboboxlist = (ComboBox_t*)view_port->parent_struct;
-                    json_add_key ("Enums");
-                    json_start_array();
+                    json_add_key (js, "Enums");
+                    json_start_array(js);
                     unsigned int k = 0;
                     for(; k<comboboxlist->list_size;k++) {
-                        json_add_string(comboboxlist->list_names[k]);
+                        json_add_string(js, comboboxlist->list_names[k]);
                     }
-                    json_close_array();
+                    json_close_array(js);
                 }
                 if (designer->controls[i].is_type == IS_MIDIKEYBOARD) {
-                    json_add_key ("MIDIPORT");
-                    json_add_int(MIDI_PORT);
+                    json_add_key (js, "MIDIPORT");
+                    json_add_int(js, MIDI_PORT);
                 }
-                json_close_value_pair();
-                json_close_array();
-                check_for_Widget_color(designer, designer->controls[i].wid);
+                json_close_value_pair(js);
+                json_close_array(js);
+                check_for_Widget_color(designer, designer->controls[i].wid, js);
             }
         }
     }
 
-    json_close_object();
+    json_close_object(js);
 }
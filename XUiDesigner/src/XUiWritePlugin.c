@@ -38,7 +38,7 @@ static void append(char **str, const char *buf) {
 -----------------------------------------------------------------------
 ----------------------------------------------------------------------*/
 
-void print_plugin(XUiDesigner *designer) {
+void print_plugin(XUiDesigner *designer, XUiString *out) {
     char * a_inputs[16];
     int a = 0;
     char * a_outputs[16];
@@ -49,66 +49,66 @@ void print_plugin(XUiDesigner *designer) {
     if (name == NULL) asprintf(&name, "%s", "noname");
     strovar(name);
 
-    printf ("\n#include <cstdlib>\n"
+    xstring_printf(out, "\n#include <cstdlib>\n"
     "#include <cmath>\n"
     "#include <iostream>\n"
     "#include <cstring>\n"
     "#include <unistd.h>\n\n"
     "#include <lv2/lv2plug.in/ns/lv2core/lv2.h>\n");
     if (designer->lv2c.midi_input || designer->lv2c.midi_output) {
-        printf ("#include <lv2/lv2plug.in/ns/ext/atom/atom.h>\n"
+        xstring_printf(out, "#include <lv2/lv2plug.in/ns/ext/atom/atom.h>\n"
         "#include <lv2/lv2plug.in/ns/ext/atom/util.h>\n"
         "#include <lv2/lv2plug.in/ns/ext/midi/midi.h>\n"
         "#include <lv2/lv2plug.in/ns/ext/urid/urid.h>\n\n");
     }
 
-    printf ("///////////////////////// MACRO SUPPORT ////////////////////////////////\n\n"
+    xstring_printf(out, "///////////////////////// MACRO SUPPORT ////////////////////////////////\n\n"
     "#define PLUGIN_URI \"%s\"\n\n"
     "using std::min;\n"
     "using std::max;\n\n",  designer->lv2c.uri);
     if (designer->is_faust_file) {
         char* tmp = strdup(designer->faust_file);
-        printf ("#define __rt_data __attribute__((section(\".rt.data\")))\n");
-        printf ("#include \"%s\"\n\n", basename(tmp));
+        xstring_printf(out, "#define __rt_data __attribute__((section(\".rt.data\")))\n");
+        xstring_printf(out, "#include \"%s\"\n\n", basename(tmp));
         free(tmp);
         tmp = NULL;
     } else if (designer->is_cc_file) {
         char* tmp = strdup(designer->cc_file);
-        printf ("#include \"%s\"\n\n", basename(tmp));
+        xstring_printf(out, "#include \"%s\"\n\n", basename(tmp));
         free(tmp);
         tmp = NULL;
     } else {
-        printf ("typedef int PortIndex;\n\n");
+        xstring_printf(out, "typedef int PortIndex;\n\n");
     }
-    printf ("////////////////////////////// PLUG-IN CLASS ///////////////////////////\n\n"
+    xstring_printf(out, "////////////////////////////// PLUG-IN CLASS ///////////////////////////\n\n"
     "namespace %s {\n\n"
     "class X%s\n"
     "{\n"
     "private:\n", name, name);
 
     if (designer->lv2c.midi_input) {
-        printf ("    LV2_URID midi_MidiEvent;\n"
+        xstring_printf(out, "    LV2_URID midi_MidiEvent;\n"
         "    LV2_URID_Map* map;\n");
     }
 
     int i = 0;
     if (designer->is_project) {
         for (;i<designer->lv2c.audio_input;i++) {
-            printf ("    float* input%i;\n", i);
+            xstring_printf(out, "    float* input%i;\n", i);
             asprintf((char**)&a_inputs[a],"input%i", i);
             a++;
         }
         i = 0;
         for (;i<designer->lv2c.audio_output;i++) {
-            printf ("    float* output%i;\n", i);
+            xstring_printf(out, "    float* output%i;\n", i);
             asprintf((char**)&a_outputs[o],"output%i", i);
             o++;
         }
         if (designer->lv2c.midi_input) {
-            printf ("    const LV2_Atom_Sequence* midi_in;\n");
+            xstring_printf(out, "    const LV2_Atom_Sequence* midi_in;\n");
         }
         if (designer->lv2c.midi_output) {
-            printf ("    LV2_Atom_Sequence* midi_out;\n");
+            xstring_printf(out, "    LV2_Atom_Sequence* midi_out;\n");
         }
         i = 0;
     }
@@ -124,15 +124,15 @@ void print_plugin(XUiDesigner *designer) {
                 char* var = strdup(designer->controls[i].wid->label);
                 strtovar(var);
                 if (designer->controls[i].is_audio_input) {
-                    printf ("    float* %s;\n", var);
+                    xstring_printf(out, "    float* %s;\n", var);
                     a_inputs[a] = strdup(var);
                     a++;
                 } else if (designer->controls[i].is_audio_output) {
-                    printf ("    float* %s;\n", var);
+                    xstring_printf(out, "    float* %s;\n", var);
                     a_outputs[o] = strdup(var);
                     o++;
                 } else if (!parse_file) {
-                    printf ("    float* %s;\n"
+                    xstring_printf(out, "    float* %s;\n"
                     "    float %s_;\n", var, var);
                 }
                 free(var);
@@ -140,17 +140,17 @@ void print_plugin(XUiDesigner *designer) {
             } else {
                 designer->lv2c.bypass = 1;
                 have_bypass = true;
-                printf ("    float* bypass;\n"
+                xstring_printf(out, "    float* bypass;\n"
                 "    float bypass_;\n");
             }
         }
     }
     if (parse_file && !have_bypass) {
-        printf ("    float* bypass;\n"
+        xstring_printf(out, "    float* bypass;\n"
         "    float bypass_;\n");
     }
     if (designer->lv2c.bypass) {
-        printf ("    // bypass ramping\n"
+        xstring_printf(out, "    // bypass ramping\n"
         "    bool needs_ramp_down;\n"
         "    bool needs_ramp_up;\n"
         "    float ramp_down;\n"
@@ -160,10 +160,10 @@ void print_plugin(XUiDesigner *designer) {
         "    bool bypassed;\n\n");
     }
     if (parse_file) {
-        printf ("    %s::Dsp* plugin;\n\n", name);
+        xstring_printf(out, "    %s::Dsp* plugin;\n\n", name);
     }
 
-    printf ("    // private functions\n"
+    xstring_printf(out, "    // private functions\n"
     "    inline void run_dsp_(uint32_t n_samples);\n"
     "    inline void connect_(uint32_t port,void* data);\n"
     "    inline void init_dsp_(uint32_t rate);\n"
@@ -188,26 +188,26 @@ void print_plugin(XUiDesigner *designer) {
     "    ~X%s();\n"
     "};\n\n", name, name);
 
-    printf ("// constructor\n"
+    xstring_printf(out, "// constructor\n"
     "X%s::X%s() :\n", name, name);
     bool add_comma = false;
     if (designer->is_project) {
         i = 0;
         for (;i<designer->lv2c.audio_input;i++) {
-            printf ("%s\n    input%i(NULL)", add_comma ? "," : "", i);
+            xstring_printf(out, "%s\n    input%i(NULL)", add_comma ? "," : "", i);
             add_comma = true;
         }
         i = 0;
         for (;i<designer->lv2c.audio_output;i++) {
-            printf ("%s\n    output%i(NULL)", add_comma ? "," : "", i);
+            xstring_printf(out, "%s\n    output%i(NULL)", add_comma ? "," : "", i);
             add_comma = true;
         }
         if (designer->lv2c.midi_input) {
-            printf ("%s\n    midi_in(NULL)", add_comma ? "," : "");
+            xstring_printf(out, "%s\n    midi_in(NULL)", add_comma ? "," : "");
             add_comma = true;
         }
         if (designer->lv2c.midi_output) {
-            printf ("%s\n    midi_out(NULL)", add_comma ? "," : "");
+            xstring_printf(out, "%s\n    midi_out(NULL)", add_comma ? "," : "");
             add_comma = true;
         }
     }
@@ -222,57 +222,57 @@ void print_plugin(XUiDesigner *designer) {
             if (!designer->controls[i].destignation_enabled && !parse_file) {
                 char* var = strdup(designer->controls[i].wid->label);
                 strtovar(var);
-                printf ("%s\n    %s(NULL)",add_comma ? "," : "", var);
+                xstring_printf(out, "%s\n    %s(NULL)",add_comma ? "," : "", var);
                 free(var);
                 var = NULL;
                 add_comma = true;
             } else if (designer->controls[i].destignation_enabled) {
-                printf ("%s\n    bypass(NULL)",add_comma ? "," : "");
+                xstring_printf(out, "%s\n    bypass(NULL)",add_comma ? "," : "");
                 add_comma = true;
-                printf ("%s\n    bypass_(2)",add_comma ? "," : "");
+                xstring_printf(out, "%s\n    bypass_(2)",add_comma ? "," : "");
             }
         }
     }
     if (parse_file && !have_bypass) {
-        printf ("%s\n    bypass(NULL)",add_comma ? "," : "");
+        xstring_printf(out, "%s\n    bypass(NULL)",add_comma ? "," : "");
         add_comma = true;
-        printf ("%s\n    bypass_(2)",add_comma ? "," : "");
+        xstring_printf(out, "%s\n    bypass_(2)",add_comma ? "," : "");
     }
     if (designer->lv2c.bypass) {
-        printf ("%s\n    needs_ramp_down(false),\n"
+        xstring_printf(out, "%s\n    needs_ramp_down(false),\n"
         "    needs_ramp_up(false),\n"
         "    bypassed(false)", add_comma ? "," : "");
     }
     if (parse_file) {
-        printf (",\n"
+        xstring_printf(out, ",\n"
         "    plugin(%s::plugin())", name);
     }
-    printf (" {};\n\n");
+    xstring_printf(out, " {};\n\n");
 
-    printf ("// destructor\n"
+    xstring_printf(out, "// destructor\n"
     "X%s::~X%s() {", name, name);
     if (parse_file) {
-        printf ("\n    plugin->del_instance(plugin);\n");
+        xstring_printf(out, "\n    plugin->del_instance(plugin);\n");
     }
-    printf ("};\n\n");
+    xstring_printf(out, "};\n\n");
 
 
-    printf ("///////////////////////// PRIVATE CLASS  FUNCTIONS /////////////////////\n\n"
+    xstring_printf(out, "///////////////////////// PRIVATE CLASS  FUNCTIONS /////////////////////\n\n"
     "void X%s::init_dsp_(uint32_t rate)\n"
     "{\n", name);
     if (parse_file) {
-        printf ("    plugin->init(rate);\n");
+        xstring_printf(out, "    plugin->init(rate);\n");
     }
     if (designer->lv2c.bypass) {
-        printf ("    // set values for internal ramping\n"
+        xstring_printf(out, "    // set values for internal ramping\n"
         "    ramp_down_step = 32 * (256 * rate) / 48000; \n"
         "    ramp_up_step = ramp_down_step;\n"
         "    ramp_down = ramp_down_step;\n"
         "    ramp_up = 0.0;\n");
     }
-    printf ("}\n\n");
+    xstring_printf(out, "}\n\n");
 
-    printf ("// connect the Ports used by the plug-in class\n"
+    xstring_printf(out, "// connect the Ports used by the plug-in class\n"
     "void X%s::connect_(uint32_t port,void* data)\n"
     "{\n"
     "    switch ((PortIndex)port)\n"
@@ -281,26 +281,26 @@ void print_plugin(XUiDesigner *designer) {
     int p = 0;
     if (designer->is_project) {
         for (;i<designer->lv2c.audio_input;i++) {
-            printf ("        case %i:\n"
+            xstring_printf(out, "        case %i:\n"
                     "            input%i = static_cast<float*>(data);\n"
                     "            break;\n", p, i);
             p++;
         }
         i = 0;
         for (;i<designer->lv2c.audio_output;i++) {
-            printf ("        case %i:\n"
+            xstring_printf(out, "        case %i:\n"
                     "            output%i = static_cast<float*>(data);\n"
                     "            break;\n", p, i);
             p++;
         }
         if (designer->lv2c.midi_input) {
-            printf ("        case %i:\n"
+            xstring_printf(out, "        case %i:\n"
                     "            midi_in = (const LV2_Atom_Sequence*)data;\n"
                     "            break;\n", p);
             p++;
         }
         if (designer->lv2c.midi_output) {
-            printf ("        case %i:\n"
+            xstring_printf(out, "        case %i:\n"
                     "            midi_out = (LV2_Atom_Sequence*)data;\n"
                     "            break;\n", p);
             p++;
@@ -319,14 +319,14 @@ void print_plugin(XUiDesigner *designer) {
             if (!designer->controls[i].destignation_enabled && !parse_file) {
                 char* var = strdup(designer->controls[i].wid->label);
                 strtovar(var);
-                printf ("        case %i:\n"
+                xstring_printf(out, "        case %i:\n"
                         "            %s = static_cast<float*>(data);\n"
                         "            break;\n", p, var);
                 p++;
                 free(var);
                 var = NULL;
             } else if (designer->controls[i].destignation_enabled) {
-                printf ("        case %i:\n"
+                xstring_printf(out, "        case %i:\n"
                         "            bypass = static_cast<float*>(data);\n"
                         "            break;\n", p);
                 p++;
@@ -334,16 +334,16 @@ void print_plugin(XUiDesigner *designer) {
         }
     }
     if (parse_file && !have_bypass) {
-        printf ("        case %i:\n"
+        xstring_printf(out, "        case %i:\n"
                 "            bypass = static_cast<float*>(data);\n"
                 "            break;\n", p);
     }
-    printf ("        default:\n"
+    xstring_printf(out, "        default:\n"
             "            break;\n"
             "    }\n"
     "}\n\n");
 
-    printf ("void X%s::activate_f()\n"
+    xstring_printf(out, "void X%s::activate_f()\n"
     "{\n"
     "    // allocate the internal DSP mem\n"
     "}\n\n"
@@ -358,13 +358,13 @@ void print_plugin(XUiDesigner *designer) {
     "    // delete the internal DSP mem\n"
     "}\n\n", name, name, name);
 
-    printf ("void X%s::run_dsp_(uint32_t n_samples)\n"
+    xstring_printf(out, "void X%s::run_dsp_(uint32_t n_samples)\n"
     "{\n"
     "    if(n_samples<1) return;\n\n", name);
 
     i = 0;
     if (!designer->controls[i].destignation_enabled && !parse_file) {
-        printf ("    // get controller values\n");
+        xstring_printf(out, "    // get controller values\n");
         for (;i<MAX_CONTROLS;i++) {
             if (designer->controls[i].wid != NULL) {
                 if (designer->controls[i].is_type == IS_FRAME ||
@@ -378,7 +378,7 @@ void print_plugin(XUiDesigner *designer) {
                 }
                 char* var = strdup(designer->controls[i].wid->label);
                 strtovar(var);
-                printf ("#define  %s_ (*(%s))\n", var, var);
+                xstring_printf(out, "#define  %s_ (*(%s))\n", var, var);
                 free(var);
                 var = NULL;
             }
@@ -386,7 +386,7 @@ void print_plugin(XUiDesigner *designer) {
     }
 
     if (designer->lv2c.midi_input) {
-        printf ("    LV2_ATOM_SEQUENCE_FOREACH(midi_in, ev) {\n"
+        xstring_printf(out, "    LV2_ATOM_SEQUENCE_FOREACH(midi_in, ev) {\n"
         "        if (ev->body.type == midi_MidiEvent) {\n"
         "            const uint8_t* const msg = (const uint8_t*)(ev + 1);\n"
         "            switch (lv2_midi_message_type(msg)) {\n"
@@ -429,13 +429,13 @@ void print_plugin(XUiDesigner *designer) {
     if (designer->lv2c.audio_input == designer->lv2c.audio_output) {
         for (;i<designer->lv2c.audio_input;i++) {
             if (i < designer->lv2c.audio_output) {
-                printf ("\n    // do inplace processing on default\n"
+                xstring_printf(out, "\n    // do inplace processing on default\n"
                 "    if(%s != %s)\n"
                 "        memcpy(%s, %s, n_samples*sizeof(float));\n\n",
                         a_outputs[i],a_inputs[i],a_outputs[i],a_inputs[i]);
                 asprintf(&oports, ", %s, %s",a_outputs[i], a_outputs[i]);
             } else {
-                printf ("    // audio input and output count is not equal\n"
+                xstring_printf(out, "    // audio input and output count is not equal\n"
                 "    // you must handle them yourself\n\n");
             }
         }
@@ -451,15 +451,15 @@ void print_plugin(XUiDesigner *designer) {
 
     if (designer->lv2c.bypass) {
         if (designer->lv2c.audio_input != designer->lv2c.audio_output) {
-            printf ("     // audio input and output count is not equal\n"
+            xstring_printf(out, "     // audio input and output count is not equal\n"
             "    // you must handle ramping yourself\n\n");
         } else {
             i = 0;
             for (;i<designer->lv2c.audio_input;i++) {
-                printf ("    float buf%i[n_samples];\n", i);
+                xstring_printf(out, "    float buf%i[n_samples];\n", i);
             }
         }
-        printf ("    // check if bypass is pressed\n"
+        xstring_printf(out, "    // check if bypass is pressed\n"
         "    if (bypass_ != static_cast<uint32_t>(*(bypass))) {\n"
         "        bypass_ = static_cast<uint32_t>(*(bypass));\n"
         "        if (!bypass_) {\n"
@@ -472,28 +472,28 @@ void print_plugin(XUiDesigner *designer) {
         "        }\n"
         "    }\n\n");
         if (designer->lv2c.audio_input == designer->lv2c.audio_output) {
-            printf ("    if (needs_ramp_down || needs_ramp_up) {\n");
+            xstring_printf(out, "    if (needs_ramp_down || needs_ramp_up) {\n");
             i = 0;
             for (;i<designer->lv2c.audio_input;i++) {
-                printf ("         memcpy(buf%i, %s, n_samples*sizeof(float));\n", i, a_inputs[i]);
+                xstring_printf(out, "         memcpy(buf%i, %s, n_samples*sizeof(float));\n", i, a_inputs[i]);
             }
-            printf ("    }\n");
+            xstring_printf(out, "    }\n");
         }
-        printf ("    if (!bypassed) {\n    ");
+        xstring_printf(out, "    if (!bypassed) {\n    ");
     }
     if (!parse_file) {
-        printf ("    for (uint32_t i = 0; i<n_samples; i++) {\n");
+        xstring_printf(out, "    for (uint32_t i = 0; i<n_samples; i++) {\n");
         i = 0;
         for (;i<designer->lv2c.audio_output;i++) {
-            printf("            float tmp%i = %s[i];\n"
+            xstring_printf(out, "            float tmp%i = %s[i];\n"
             "            //do your dsp\n"
             "            %s[i] = tmp%i;\n", i, a_outputs[i], a_outputs[i], i);
         }
-        printf ("        }\n\n");
+        xstring_printf(out, "        }\n\n");
     } else {
         //if (designer->lv2c.audio_input == designer->lv2c.audio_output) {
             
-            printf ("    plugin->compute(n_samples%s);\n    }\n\n", oports);
+            xstring_printf(out, "    plugin->compute(n_samples%s);\n    }\n\n", oports);
         //}
         free(oports);
         oports = NULL;
@@ -501,11 +501,11 @@ void print_plugin(XUiDesigner *designer) {
     
     if (designer->lv2c.bypass) {
         if (designer->lv2c.audio_input != designer->lv2c.audio_output) {
-            printf ("     // audio input and output count is not equal\n"
+            xstring_printf(out, "     // audio input and output count is not equal\n"
             "    // you must handle ramping yourself\n\n");
         } else {
         
-            printf (
+            xstring_printf(out,
             "    // check if ramping is needed\n"
             "    if (needs_ramp_down) {\n"
             "        float fade = 0;\n"
@@ -516,10 +516,10 @@ void print_plugin(XUiDesigner *designer) {
             "            fade = max(0.0f,ramp_down) /ramp_down_step ;\n");
             i = 0;
             for (;i<designer->lv2c.audio_input;i++) {            
-                printf ("            %s[i] = %s[i] * fade + buf%i[i] * (1.0 - fade);\n",
+                xstring_printf(out, "            %s[i] = %s[i] * fade + buf%i[i] * (1.0 - fade);\n",
                         a_outputs[i], a_outputs[i], i);
             }
-            printf ("        }\n"
+            xstring_printf(out, "        }\n"
 
             "        if (ramp_down <= 0.0) {\n"
             "            // when ramped down, clear buffer from dsp\n"
@@ -542,10 +542,10 @@ void print_plugin(XUiDesigner *designer) {
             parse_file ? "plugin->clear_state_f();\n" : "");
             i = 0;
             for (;i<designer->lv2c.audio_input;i++) {            
-                printf ("            %s[i] = %s[i] * fade + buf%i[i] * (1.0 - fade);\n",
+                xstring_printf(out, "            %s[i] = %s[i] * fade + buf%i[i] * (1.0 - fade);\n",
                         a_outputs[i], a_outputs[i], i);
             }
-            printf ("        }\n"
+            xstring_printf(out, "        }\n"
 
             "        if (ramp_up >= ramp_up_step) {\n"
             "            needs_ramp_up = false;\n"
@@ -572,25 +572,25 @@ void print_plugin(XUiDesigner *designer) {
             if (!designer->controls[i].destignation_enabled && !parse_file) {
                 char* var = strdup(designer->controls[i].wid->label);
                 strtovar(var);
-                printf ("#undef  %s_\n", var);
+                xstring_printf(out, "#undef  %s_\n", var);
                 free(var);
                 var = NULL;
             }
         }
     }
-    printf("}\n\n"
+    xstring_printf(out, "}\n\n"
 
     "void X%s::connect_all__ports(uint32_t port, void* data)\n"
     "{\n"
     "    // connect the Ports used by the plug-in class\n"
     "    connect_(port,data); \n", name);
     if (parse_file) {
-        printf("    plugin->connect(port,data);");
+        xstring_printf(out, "    plugin->connect(port,data);");
     }
     
-    printf("}\n\n");
+    xstring_printf(out, "}\n\n");
 
-    printf("////////////////////// STATIC CLASS  FUNCTIONS  ////////////////////////\n\n"
+    xstring_printf(out, "////////////////////// STATIC CLASS  FUNCTIONS  ////////////////////////\n\n"
 
     "LV2_Handle \n"
     "X%s::instantiate(const LV2_Descriptor* descriptor,\n"
@@ -598,7 +598,7 @@ void print_plugin(XUiDesigner *designer) {
     "                            const LV2_Feature* const* features)\n"
     "{\n",name);
     if (designer->lv2c.midi_input) {
-        printf("    LV2_URID_Map* map = NULL;\n"
+        xstring_printf(out, "    LV2_URID_Map* map = NULL;\n"
         "    for (int i = 0; features[i]; ++i) {\n"
         "        if (!strcmp(features[i]->URI, LV2_URID__map)) {\n"
         "            map = (LV2_URID_Map*)features[i]->data;\n"
@@ -609,21 +609,21 @@ void print_plugin(XUiDesigner *designer) {
         "        return NULL;\n"
         "    }\n");
     }
-    printf("    // init the plug-in class\n"
+    xstring_printf(out, "    // init the plug-in class\n"
     "    X%s *self = new X%s();\n"
     "    if (!self) {\n"
     "        return NULL;\n"
     "    }\n", name, name);
     if (designer->lv2c.midi_input) {
-        printf("    self->map = map;\n"
+        xstring_printf(out, "    self->map = map;\n"
         "    self->midi_MidiEvent = map->map(map->handle, LV2_MIDI__MidiEvent);\n");
     }
-    printf("    self->init_dsp_((uint32_t)rate);\n"
+    xstring_printf(out, "    self->init_dsp_((uint32_t)rate);\n"
 
     "    return (LV2_Handle)self;\n"
     "}\n\n");
 
-    printf("void X%s::connect_port(LV2_Handle instance, \n"
+    xstring_printf(out, "void X%s::connect_port(LV2_Handle instance, \n"
     "                                   uint32_t port, void* data)\n"
     "{\n"
     "    // connect all ports\n"
@@ -656,7 +656,7 @@ void print_plugin(XUiDesigner *designer) {
     "    delete self;\n"
     "}\n\n", name, name, name, name, name, name, name, name, name, name, name);
 
-    printf("const LV2_Descriptor X%s::descriptor =\n"
+    xstring_printf(out, "const LV2_Descriptor X%s::descriptor =\n"
     "{\n"
     "    PLUGIN_URI ,\n"
     "    X%s::instantiate,\n"
@@ -669,11 +669,11 @@ void print_plugin(XUiDesigner *designer) {
     "};\n\n", name, name, name, name, name, name, name);
 
 
-    printf("} // end namespace %s\n\n"
+    xstring_printf(out, "} // end namespace %s\n\n"
 
     "////////////////////////// LV2 SYMBOL EXPORT ///////////////////////////\n\n", name);
 
-    printf("LV2_SYMBOL_EXPORT\n"
+    xstring_printf(out, "LV2_SYMBOL_EXPORT\n"
     "const LV2_Descriptor*\n"
     "lv2_descriptor(uint32_t index)\n"
     "{\n"
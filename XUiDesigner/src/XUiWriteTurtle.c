@@ -28,14 +28,14 @@
 -----------------------------------------------------------------------
 ----------------------------------------------------------------------*/
 
-void print_manifest(XUiDesigner *designer) {
+void print_manifest(XUiDesigner *designer, XUiString *out) {
     char *name = NULL;
     XFetchName(designer->ui->app->dpy, designer->ui->widget, &name);
     if (name == NULL) asprintf(&name, "%s", "noname");
     strdecode(name, " ", "_");
 
     if (!designer->generate_ui_only) {
-        printf ("\n@prefix lv2:  <http://lv2plug.in/ns/lv2core#> .\n"
+        xstring_printf(out, "\n@prefix lv2:  <http://lv2plug.in/ns/lv2core#> .\n"
             "@prefix rdfs: <http://www.w3.org/2000/01/rdf-schema#> .\n"
 
             "<%s>\n"
@@ -43,7 +43,7 @@ void print_manifest(XUiDesigner *designer) {
             "    lv2:binary <%s.so> ;\n"
             "    rdfs:seeAlso <%s.ttl> .\n", designer->lv2c.uri, name, name);
     } else {
-        printf ("\n@prefix guiext: <http://lv2plug.in/ns/extensions/ui#>.\n"
+        xstring_printf(out, "\n@prefix guiext: <http://lv2plug.in/ns/extensions/ui#>.\n"
             "\n@prefix lv2:  <http://lv2plug.in/ns/lv2core#> .\n"
             "@prefix rdfs: <http://www.w3.org/2000/01/rdf-schema#> .\n"
 
@@ -62,11 +62,11 @@ void print_manifest(XUiDesigner *designer) {
 -----------------------------------------------------------------------
 ----------------------------------------------------------------------*/
 
-void print_ttl(XUiDesigner *designer) {
+void print_ttl(XUiDesigner *designer, XUiString *out) {
     char *name = NULL;
     XFetchName(designer->ui->app->dpy, designer->ui->widget, &name);
     if (name == NULL) asprintf(&name, "%s", "noname");
-    printf ("\n@prefix doap:  <http://usefulinc.com/ns/doap#> .\n"
+    xstring_printf(out, "\n@prefix doap:  <http://usefulinc.com/ns/doap#> .\n"
         "@prefix foaf:   <http://xmlns.com/foaf/0.1/> .\n"
         "@prefix lv2:    <http://lv2plug.in/ns/lv2core#> .\n"
         "@prefix rdf:    <http://www.w3.org/1999/02/22-rdf-syntax-ns#> .\n"
@@ -82,7 +82,7 @@ void print_ttl(XUiDesigner *designer) {
         "@prefix patch:  <http://lv2plug.in/ns/ext/patch#> .\n\n\n");
 
     if (!designer->generate_ui_only) {
-        printf ("<urn:name#me>\n"
+        xstring_printf(out, "<urn:name#me>\n"
                 "   a foaf:Person ;\n"
                 "   foaf:name \"%s\" .\n\n"
 
@@ -112,21 +112,21 @@ void print_ttl(XUiDesigner *designer) {
             if (designer->controls[i].is_atom_patch) {
                 Widget_t * wid = designer->controls[i].wid;
                 const char* uri = (const char*) wid->parent_struct;
-                printf("\n<%s>\n"
+                xstring_printf(out, "\n<%s>\n"
                        "    a lv2:Parameter ;\n"
                        "        rdfs:label \"%s\" ;\n", uri, wid->label);
-                if (designer->controls[i].port_index == -1) printf("        rdfs:range atom:Float");
-                else if (designer->controls[i].port_index == -2) printf("        rdfs:range atom:Int");
-                else if (designer->controls[i].port_index == -3) printf("        rdfs:range atom:Bool");
-                else if (designer->controls[i].port_index == -4) printf("        rdfs:range atom:Path");
+                if (designer->controls[i].port_index == -1) xstring_printf(out, "        rdfs:range atom:Float");
+                else if (designer->controls[i].port_index == -2) xstring_printf(out, "        rdfs:range atom:Int");
+                else if (designer->controls[i].port_index == -3) xstring_printf(out, "        rdfs:range atom:Bool");
+                else if (designer->controls[i].port_index == -4) xstring_printf(out, "        rdfs:range atom:Path");
                 if (designer->controls[i].have_adjustment) {
-                    printf(" ;\n"
+                    xstring_printf(out, " ;\n"
                            "        lv2:default %f ;\n"
                            "        lv2:minimum %f ;\n"
                            "        lv2:maximum %f .\n", adj_get_std_value(wid->adj),
                                     adj_get_min_value(wid->adj), adj_get_max_value(wid->adj));
                 } else {
-                    printf(" .\n");
+                    xstring_printf(out, " .\n");
                 }
             }
         }
@@ -134,10 +134,10 @@ void print_ttl(XUiDesigner *designer) {
         i = 0;
         int p = 0;
         bool add_comma = false;
-        printf ("\n   lv2:port ");
+        xstring_printf(out, "\n   lv2:port ");
         if (designer->is_project) {
             for (;i<designer->lv2c.audio_input;i++) {
-                printf ("%s [\n"
+                xstring_printf(out, "%s [\n"
                 "       a lv2:AudioPort ,\n"
                 "          lv2:InputPort ;\n"
                 "      lv2:index %i ;\n"
@@ -149,7 +149,7 @@ void print_ttl(XUiDesigner *designer) {
             }
             i = 0;
             for (;i<designer->lv2c.audio_output;i++) {
-                printf ("%s [\n"
+                xstring_printf(out, "%s [\n"
                 "      a lv2:AudioPort ,\n"
                 "           lv2:OutputPort ;\n"
                 "      lv2:index %i ;\n"
@@ -161,7 +161,7 @@ void print_ttl(XUiDesigner *designer) {
             }
             if (designer->lv2c.midi_input) {
 
-                printf ("%s [\n"
+                xstring_printf(out, "%s [\n"
                 "      a lv2:InputPort ,\n"
                 "          atom:AtomPort ;\n"
                 "      atom:bufferType atom:Sequence ;\n"
@@ -177,7 +177,7 @@ void print_ttl(XUiDesigner *designer) {
             }
             if (designer->lv2c.midi_output) {
 
-                printf ("%s [\n"
+                xstring_printf(out, "%s [\n"
                 "      a lv2:OutputPort ,\n"
                 "          atom:AtomPort ;\n"
                 "      atom:bufferType atom:Sequence ;\n"
@@ -204,7 +204,7 @@ void print_ttl(XUiDesigner *designer) {
                 }
             }
             if (!have_bypass) {
-                printf (", [\n"
+                xstring_printf(out, ", [\n"
                     "      a lv2:InputPort ,\n"
                     "          lv2:ControlPort ;\n"
                     "      lv2:index %i ;\n"
@@ -231,7 +231,9 @@ void print_ttl(XUiDesigner *designer) {
                     if (designer->controls[i].is_atom_patch) {
                         continue;
                     }
-                    strtosym(designer->controls[i].symbol);
+                    // the generators run side by side, so sanitize a copy
+                    char *sym = strdup(designer->controls[i].symbol);
+                    strtosym(sym);
                     char *xldl = NULL;
                     asprintf(&xldl, "%s", designer->controls[i].wid->label);
                     strtovar(xldl);
@@ -240,7 +242,7 @@ void print_ttl(XUiDesigner *designer) {
                             Widget_t *menu = wid->childlist->childs[1];
                             Widget_t* view_port =  menu->childlist->childs[0];
                             ComboBox_t *comboboxlist = (ComboBox_t*)view_port->parent_struct;
-                            printf ("%s [\n"
+                            xstring_printf(out, "%s [\n"
                                 "      a lv2:InputPort ,\n"
                                 "          lv2:ControlPort ;\n"
                                 "      lv2:index %i ;\n"
@@ -252,19 +254,19 @@ void print_ttl(XUiDesigner *designer) {
                                 "      lv2:portProperty lv2:integer ;\n"
                                 "      lv2:portProperty lv2:enumeration ;\n"
                                     , add_comma ? ",": "", designer->is_project ? p : designer->controls[i].port_index,
-                                    designer->controls[i].symbol, xldl, adj_get_std_value(wid->adj),
+                                    sym, xldl, adj_get_std_value(wid->adj),
                                     adj_get_min_value(wid->adj), adj_get_max_value(wid->adj));
                                 add_comma = true;
                             unsigned int k = 0;
                             int l = (int)adj_get_min_value(wid->adj);
                             for(; k<comboboxlist->list_size;k++) {
-                                printf ("      lv2:scalePoint [rdfs:label \"%s\"; rdf:value %i];\n", comboboxlist->list_names[k],l);
+                                xstring_printf(out, "      lv2:scalePoint [rdfs:label \"%s\"; rdf:value %i];\n", comboboxlist->list_names[k],l);
                                 l++;
                             }
-                            printf ("]");
+                            xstring_printf(out, "]");
                         } else if (designer->controls[i].is_type == IS_VMETER ||
                                 designer->controls[i].is_type == IS_HMETER) {
-                            printf ("%s [\n"
+                            xstring_printf(out, "%s [\n"
                                 "      a lv2:OutputPort ,\n"
                                 "          lv2:ControlPort ;\n"
                                 "      lv2:index %i ;\n"
@@ -274,11 +276,11 @@ void print_ttl(XUiDesigner *designer) {
                                 "      lv2:minimum %f ;\n"
                                 "      lv2:maximum %f ;\n"
                                 "   ]", add_comma ? ",": "", designer->is_project ? p : designer->controls[i].port_index,
-                                    designer->controls[i].symbol, xldl, adj_get_std_value(wid->adj),
+                                    sym, xldl, adj_get_std_value(wid->adj),
                                     adj_get_min_value(wid->adj), adj_get_max_value(wid->adj));
                                 add_comma = true;
                         } else {
-                            printf ("%s [\n"
+                            xstring_printf(out, "%s [\n"
                                 "      a lv2:InputPort ,\n"
                                 "          lv2:ControlPort ;\n"
                                 "      lv2:index %i ;\n"
@@ -288,32 +290,32 @@ void print_ttl(XUiDesigner *designer) {
                                 "      lv2:minimum %f ;\n"
                                 "      lv2:maximum %f ;\n"
                                 "   ]", add_comma ? ",": "", designer->is_project ? p : designer->controls[i].port_index,
-                                    designer->controls[i].symbol, xldl, adj_get_std_value(wid->adj),
+                                    sym, xldl, adj_get_std_value(wid->adj),
                                     adj_get_min_value(wid->adj), adj_get_max_value(wid->adj));
                                 add_comma = true;
                         }
                     } else if (designer->controls[i].is_audio_input) {
-                        printf ("%s [\n"
+                        xstring_printf(out, "%s [\n"
                             "       a lv2:AudioPort ,\n"
                             "          lv2:InputPort ;\n"
                             "      lv2:index %i ;\n"
                             "      lv2:symbol \"%s\" ;\n"
                             "      lv2:name \"%s\" ;\n"
                             "   ]", add_comma ? ",": "", designer->is_project ? p : designer->controls[i].port_index,
-                                designer->controls[i].symbol, xldl);
+                                sym, xldl);
                             add_comma = true;
                     } else if (designer->controls[i].is_audio_output) {
-                        printf ("%s [\n"
+                        xstring_printf(out, "%s [\n"
                             "       a lv2:AudioPort ,\n"
                             "          lv2:OutputPort ;\n"
                             "      lv2:index %i ;\n"
                             "      lv2:symbol \"%s\" ;\n"
                             "      lv2:name \"%s\" ;\n"
                             "   ]", add_comma ? ",": "", designer->is_project ? p : designer->controls[i].port_index,
-                                designer->controls[i].symbol, xldl);                        
+                                sym, xldl);                        
                             add_comma = true;
                     } else if (designer->controls[i].is_atom_output) {
-                        printf ("%s [\n"
+                        xstring_printf(out, "%s [\n"
                             "      a lv2:OutputPort ,\n"
                             "          atom:AtomPort ;\n"
                             "      atom:bufferType atom:Sequence ;\n"
@@ -324,10 +326,10 @@ void print_ttl(XUiDesigner *designer) {
                             "      lv2:symbol \"%s\" ;\n"
                             "      lv2:name \"%s\" ;\n"
                             "   ]", add_comma ? ",": "", designer->is_project ? p : designer->controls[i].port_index,
-                                designer->controls[i].symbol, xldl);
+                                sym, xldl);
                             add_comma = true;
                     } else if (designer->controls[i].is_atom_input) {
-                        printf ("%s [\n"
+                        xstring_printf(out, "%s [\n"
                             "      a lv2:InputPort ,\n"
                             "          atom:AtomPort ;\n"
                             "      atom:bufferType atom:Sequence ;\n"
@@ -338,11 +340,11 @@ void print_ttl(XUiDesigner *designer) {
                             "      lv2:symbol \"%s\" ;\n"
                             "      lv2:name \"%s\" ;\n"
                             "   ]", add_comma ? ",": "", designer->is_project ? p : designer->controls[i].port_index,
-                                designer->controls[i].symbol, xldl);
+                                sym, xldl);
                             add_comma = true;
                     } else if (designer->controls[i].is_type == IS_TOGGLE_BUTTON ||
                             designer->controls[i].is_type == IS_IMAGE_TOGGLE) {
-                        printf ("%s [\n"
+                        xstring_printf(out, "%s [\n"
                             "      a lv2:InputPort ,\n"
                             "          lv2:ControlPort ;\n"
                             "      lv2:index %i ;\n"
@@ -355,12 +357,12 @@ void print_ttl(XUiDesigner *designer) {
                             "      lv2:maximum 1 ;\n"
                             "   ]", add_comma ? ",": "", designer->is_project ? p : designer->controls[i].port_index,
                                 designer->controls[i].destignation_enabled ? "      lv2:designation lv2:enabled;\n" : "",
-                                designer->controls[i].symbol, xldl,
+                                sym, xldl,
                                 designer->controls[i].destignation_enabled ? 1 : 0);
                             add_comma = true;
                     } else if (designer->controls[i].is_type == IS_BUTTON ||
                             designer->controls[i].is_type == IS_IMAGE_BUTTON) {
-                        printf ("%s [\n"
+                        xstring_printf(out, "%s [\n"
                             "      a lv2:InputPort ,\n"
                             "          lv2:ControlPort ;\n"
                             "      lv2:index %i ;\n"
@@ -371,10 +373,11 @@ void print_ttl(XUiDesigner *designer) {
                             "      lv2:minimum 0 ;\n"
                             "      lv2:maximum 1 ;\n"
                             "   ]", add_comma ? ",": "", designer->is_project ? p : designer->controls[i].port_index,
-                                 designer->controls[i].symbol, xldl);
+                                 sym, xldl);
                             add_comma = true;
                     }
                     free(xldl);
+                    free(sym);
                 }
             }
             p++;
@@ -383,12 +386,12 @@ void print_ttl(XUiDesigner *designer) {
         for (;i<MAX_CONTROLS;i++) {
             if (designer->controls[i].is_atom_patch) {
                 Widget_t * wid = designer->controls[i].wid;
-                printf (" ;\npatch:writable <%s>", (const char*) wid->parent_struct);
+                xstring_printf(out, " ;\npatch:writable <%s>", (const char*) wid->parent_struct);
             }
         }
-        printf (" .\n\n");
+        xstring_printf(out, " .\n\n");
         strdecode(name, " ", "_");
-        printf ("\n<%s>\n"
+        xstring_printf(out, "\n<%s>\n"
             "   a guiext:X11UI;\n"
             "   guiext:binary <%s_ui.so> ;\n"
             "       lv2:extensionData guiext::idle ;\n"
@@ -402,7 +405,7 @@ void print_ttl(XUiDesigner *designer) {
         for (;i<MAX_CONTROLS;i++) {
             if (designer->controls[i].wid != NULL) {
                 if (designer->controls[i].is_atom_output) {
-                    printf ("\n       guiext:portNotification [\n"
+                    xstring_printf(out, "\n       guiext:portNotification [\n"
                         "           guiext:plugin  <%s> ;\n"
                         "           lv2:symbol \"%s\" ;\n"
                         "           guiext:notifyType atom:Blank\n"
@@ -410,10 +413,10 @@ void print_ttl(XUiDesigner *designer) {
                 }
             }
         }
-        printf (" .\n");
+        xstring_printf(out, " .\n");
     } else {
         int i = 0;
-        printf ("<%s>\n"
+        xstring_printf(out, "<%s>\n"
             "   lv2:extensionData guiext::idle ;\n"
             "   lv2:extensionData guiext:resize ;\n"
             "   lv2:extensionData guiext:idleInterface ;\n"
@@ -424,7 +427,7 @@ void print_ttl(XUiDesigner *designer) {
         for (;i<MAX_CONTROLS;i++) {
             if (designer->controls[i].wid != NULL) {
                 if (designer->controls[i].is_atom_output) {
-                    printf ("\n       guiext:portNotification [\n"
+                    xstring_printf(out, "\n       guiext:portNotification [\n"
                         "           guiext:plugin  <%s> ;\n"
                         "           lv2:symbol \"%s\" ;\n"
                         "           guiext:notifyType atom:Blank\n"
@@ -432,7 +435,7 @@ void print_ttl(XUiDesigner *designer) {
                 }
             }
         }
-        printf (" .\n");
+        xstring_printf(out, " .\n");
         
     }
     free(name);
@@ -25,6 +25,8 @@
 #include <ctype.h>
 
 #include "XUiWriteUI.h"
+#include "XUiEmbed.h"
+#include "XUiAtlas.h"
 #include "XUiGenerator.h"
 
 
@@ -67,81 +69,124 @@ const char* parse_adjusment_type(CL_type cl_type) {
 -----------------------------------------------------------------------
 ----------------------------------------------------------------------*/
 
-void png2c(char* image_name, char* filepath) {
-    cairo_surface_t *image = cairo_image_surface_create_from_png(image_name);
-    int w = cairo_image_surface_get_width(image);
-    int h = cairo_image_surface_get_height(image);
-    int stride = cairo_format_stride_for_width(CAIRO_FORMAT_ARGB32, w);
-
-    char * xld = NULL;
-    char * xldl = NULL;
-    char* tmp = strdup(image_name);
-    asprintf(&xld, "%s", basename(tmp));
-    free(tmp);
-    tmp = NULL;
-    strdecode(xld, ".png", ".c");
-    strdecode(xld, "-", "_");
-    strdecode(xld, " ", "_");
-    asprintf(&xldl, "%s/%s",filepath, xld);
-    FILE *fp;
-    fp = fopen(xldl, "w");
-    if (fp == NULL) {
-        fprintf(stderr, "can't open file %s\n", xldl);
-        return ;
+// repeats of three and more pixels become (0x80000000 | n, pixel), anything else (n, n pixels)
+static size_t rle_encode(const uint32_t *px, size_t count, uint32_t *out) {
+    size_t o = 0;
+    size_t i = 0;
+    while (i < count) {
+        size_t run = 1;
+        while (i + run < count && px[i+run] == px[i] && run < 0x7fffffff) run++;
+        if (run >= 3) {
+            out[o++] = 0x80000000u | (uint32_t)run;
+            out[o++] = px[i];
+            i += run;
+        } else {
+            size_t start = i;
+            size_t n = 0;
+            while (i < count && n < 0x7fffffff) {
+                if (i + 2 < count && px[i] == px[i+1] && px[i] == px[i+2]) break;
+                i++;
+                n++;
+            }
+            out[o++] = (uint32_t)n;
+            memcpy(&out[o], &px[start], n * sizeof(uint32_t));
+            o += n;
+        }
     }
+    return o;
+}
 
+// write the premultiplied ARGB32 pixels of an image surface as CairoImageData,
+// run length encoded when that comes out smaller than the plain pixels
+int png2c_surface(cairo_surface_t *image, const char* name, XUiString *out) {
+    if (cairo_surface_status(image) != CAIRO_STATUS_SUCCESS) return -1;
+    cairo_surface_flush(image);
+    int w = cairo_image_surface_get_width(image);
+    int h = cairo_image_surface_get_height(image);
+    int stride = cairo_image_surface_get_stride(image);
     const unsigned char *buff = cairo_image_surface_get_data(image);
-    strdecode(xld, ".c", "");
-    strtoguard(xld);
-    fprintf(fp,
+
+    char *guard = strdup(name);
+    strtoguard(guard);
+    char *var = strdup(name);
+    strtovar(var);
+    xstring_printf(out,
         "\n#pragma once\n\n"
         "#ifndef %s_H_\n"
         "#define %s_H_\n\n"
         "#ifdef __cplusplus\n"
         "extern \"C\" {\n"
-        "#endif\n", xld, xld);
+        "#endif\n", guard, guard);
 
-    strtovar(xld);
-    fprintf(fp, "\n\n"
-        "static const unsigned char %s_data[] = {\n", xld);
-    int i = 0;
-    int j = 0;
-    int k = 1;
-    int c = 4;
-    for (; i < w * h * c; i++) {
-        if (j == 15 ) {
-            fprintf(fp, "0x%02x,\n", buff[i]);
-            j = 0;
-            k = 0;
-        } else if (k == c ){
-            fprintf(fp, "0x%02x,  ", buff[i]);
-            j++;
-            k = 0;
-        } else if (j == 0) {
-            fprintf(fp, "    0x%02x, ", buff[i]);
-            j++;
-        } else {
-            fprintf(fp, "0x%02x, ", buff[i]);
-            j++;
+    size_t count = (size_t)(stride/4) * h;
+    uint32_t *words = (uint32_t*)malloc((count * 2 + 2) * sizeof(uint32_t));
+    size_t len = rle_encode((const uint32_t*)buff, count, words);
+    if (len < count) {
+        xstring_printf(out, "\n\nstatic const unsigned int %s_rle[] = {\n", var);
+        embed_hex_words(out, words, len, 8, false);
+        xstring_printf(out, "};\n\n");
+        xstring_printf(out, "CairoImageData %s = (CairoImageData) {\n"
+            "    .stride = %i,\n"
+            "    .width  = %i,\n"
+            "    .height = %i,\n"
+            "    .data = NULL,\n"
+            "    .rle = %s_rle,\n"
+            "    .rle_len = %zu,\n};\n\n", var, stride, w, h, var, len);
+    } else {
+        xstring_printf(out, "\n\nstatic const unsigned char %s_data[] = {\n", var);
+        int y = 0;
+        for (;y<h;y++) {
+            embed_hex_bytes(out, buff + y * stride, stride, 16, y + 1 < h);
         }
-        k++;
+        xstring_printf(out, "};\n\n");
+        xstring_printf(out, "CairoImageData %s = (CairoImageData) {\n"
+            "    .stride = %i,\n"
+            "    .width  = %i,\n"
+            "    .height = %i,\n"
+            "    .data = (unsigned char*)%s_data,\n};\n\n", var, stride, w, h, var);
     }
-    fprintf(fp, "};\n\n");
-    fprintf(fp, "CairoImageData %s = (CairoImageData) {\n"
-        "    .stride = %i,\n"
-        "    .width  = %i,\n"
-        "    .height = %i,\n"
-        "    .data = (unsigned char*)%s_data,\n};\n\n",xld, stride, w, h, xld);
+    free(words);
 
-    fprintf(fp, "#ifdef __cplusplus\n"
+    xstring_printf(out, "#ifdef __cplusplus\n"
     "}\n"
     "#endif\n"
     "#endif\n");
 
-    fclose(fp);
+    free(guard);
+    free(var);
+    return 0;
+}
+
+int png2c_source(const char* image_name, const char* name, XUiString *out) {
+    cairo_surface_t *image = cairo_image_surface_create_from_png(image_name);
+    int ret = png2c_surface(image, name, out);
+    cairo_surface_destroy(image);
+    return ret;
+}
+
+void png2c(char* image_name, char* filepath) {
+    char * xld = NULL;
+    char * xldl = NULL;
+    char* tmp = strdup(image_name);
+    asprintf(&xld, "%s", basename(tmp));
+    free(tmp);
+    tmp = NULL;
+    strdecode(xld, ".png", ".c");
+    strdecode(xld, "-", "_");
+    strdecode(xld, " ", "_");
+    asprintf(&xldl, "%s/%s",filepath, xld);
+    strdecode(xld, ".c", "");
+
+    XUiString out;
+    xstring_init(&out);
+    if (png2c_source(image_name, xld, &out)) {
+        fprintf(stderr, "can't load image %s\n", image_name);
+    } else if (xstring_write_file(&out, xldl)) {
+        fprintf(stderr, "can't open file %s\n", xldl);
+    }
+    xstring_free(&out);
     free(xld);
     free(xldl);
-    cairo_surface_destroy(image);
 }
 
 
@@ -151,10 +196,10 @@ void png2c(char* image_name, char* filepath) {
 -----------------------------------------------------------------------
 ----------------------------------------------------------------------*/
 
-static void print_colors(XUiDesigner *designer) {
+static void print_colors(XUiDesigner *designer, XUiString *out) {
     //Xputty * main = designer->w->app;
     Colors *c = &designer->ui->color_scheme->normal;
-    printf (
+    xstring_printf(out,
     "void set_costum_theme(Widget_t *w) {\n"
     "    w->color_scheme->normal = (Colors) {\n"
     "         /* cairo    / r  / g  / b  / a  /  */\n"
@@ -174,7 +219,7 @@ static void print_colors(XUiDesigner *designer) {
                 c->light[0],c->light[1],c->light[2],c->light[3]);
 
     c = &designer->ui->color_scheme->prelight;
-    printf (
+    xstring_printf(out,
     "    w->color_scheme->prelight = (Colors) {\n"
     "         /* cairo    / r  / g  / b  / a  /  */\n"
     "        .fg =       { %.3f, %.3f, %.3f, %.3f},\n"
@@ -193,7 +238,7 @@ static void print_colors(XUiDesigner *designer) {
                 c->light[0],c->light[1],c->light[2],c->light[3]);
 
     c = &designer->ui->color_scheme->selected;
-    printf (
+    xstring_printf(out,
     "    w->color_scheme->selected = (Colors) {\n"
     "         /* cairo    / r  / g  / b  / a  /  */\n"
     "        .fg =       { %.3f, %.3f, %.3f, %.3f},\n"
@@ -212,7 +257,7 @@ static void print_colors(XUiDesigner *designer) {
                 c->light[0],c->light[1],c->light[2],c->light[3]);
 
     c = &designer->ui->color_scheme->active;
-    printf (
+    xstring_printf(out,
     "    w->color_scheme->active = (Colors) {\n"
     "         /* cairo    / r  / g  / b  / a  /  */\n"
     "        .fg =       { %.3f, %.3f, %.3f, %.3f},\n"
@@ -231,7 +276,7 @@ static void print_colors(XUiDesigner *designer) {
                 c->light[0],c->light[1],c->light[2],c->light[3]);
 
     c = &designer->ui->color_scheme->insensitive;
-    printf (
+    xstring_printf(out,
     "    w->color_scheme->insensitive = (Colors) {\n"
     "         /* cairo    / r  / g  / b  / a  /  */\n"
     "        .fg =       { %.3f, %.3f, %.3f, %.3f},\n"
@@ -275,7 +320,42 @@ static double *get_selected_color(Colors *c, int s) {
     return use;
 }
 
-static void check_for_Widget_colors(XUiDesigner *designer) {
+// tab_elem index of the tab page a control sits on
+static int tab_elem_index(XUiDesigner *designer, int n) {
+    int i = 0;
+    int e = 0;
+    int t = 0;
+    for (;i<MAX_CONTROLS;i++) {
+        if (designer->controls[i].wid != NULL && (designer->controls[i].is_type == IS_FRAME ||
+                                                designer->controls[i].is_type == IS_IMAGE ||
+                                                designer->controls[i].is_type == IS_TABBOX)) {
+            if (e == designer->controls[n].in_frame-1) return t + designer->controls[n].in_tab-1;
+            if (designer->controls[i].is_type == IS_TABBOX) {
+                t += designer->controls[i].wid->childlist->elem;
+            }
+            e++;
+        }
+    }
+    return -1;
+}
+
+// tab_elem index of the page a control gets created on when it's shown first, or -1
+static int lazy_tab_page(XUiDesigner *designer, int n) {
+    if (designer->run_test || !adj_get_value(designer->lazy_tabs->adj)) return -1;
+    // the first page is visible on start and the keyboard receives the keys of all widgets
+    if (designer->controls[n].in_tab < 2 || designer->controls[n].is_midi_patch) return -1;
+    return tab_elem_index(designer, n);
+}
+
+// how check_for_Widget_colors() writes the color overrides
+typedef enum {
+    COLORS_CODE,
+    COLORS_PREVIEW,
+    COLORS_TABLE,
+} ColorOutput;
+
+static void check_for_Widget_colors(XUiDesigner *designer, ColorOutput mode, XUiString *out,
+                                                            XUiString *pages) {
     int j = 0;  // Color_state
     for(;j<5;j++) {
         int k = 0; // Color_mod
@@ -296,8 +376,16 @@ static void check_for_Widget_colors(XUiDesigner *designer) {
                     Widget_t * wid = designer->controls[i].wid;
                     double *b = get_selected_color(get_color_scheme(wid, j), k);
                     a = memcmp(c, b, 4 * sizeof(double));
-                    if (a != 0) {
-                        printf("\n    set_widget_color(ui->widget[%i], %i, %i,"
+                    if (a != 0 && mode == COLORS_PREVIEW) {
+                        xstring_printf(out, "color\tw%i\t%i\t%i\t%.3f\t%.3f\t%.3f\t%.3f\n",
+                                                x, j, k, b[0], b[1], b[2], b[3]);
+                    } else if (a != 0 && mode == COLORS_TABLE) {
+                        xstring_printf(out, "    {%i, %i, %i, %.3f, %.3f, %.3f, %.3f},\n",
+                                                x, j, k, b[0], b[1], b[2], b[3]);
+                    } else if (a != 0) {
+                        int page = pages ? lazy_tab_page(designer, i) : -1;
+                        xstring_printf(page >= 0 ? &pages[page] : out,
+                                "\n    set_widget_color(ui->widget[%i], %i, %i,"
                                 "%.3f, %.3f, %.3f, %.3f);\n", x, j, k, b[0], b[1], b[2], b[3]);
                     }
                     x++;
@@ -307,7 +395,7 @@ static void check_for_Widget_colors(XUiDesigner *designer) {
     }
 }
 
-static void check_for_elem_colors(XUiDesigner *designer) {
+static void check_for_elem_colors(XUiDesigner *designer, bool preview, XUiString *out) {
     int j = 0;  // Color_state
     for(;j<5;j++) {
         int k = 0; // Color_mod
@@ -325,8 +413,11 @@ static void check_for_elem_colors(XUiDesigner *designer) {
                         Widget_t * wid = designer->controls[i].wid;
                         double *b = get_selected_color(get_color_scheme(wid, j), k);
                         a = memcmp(c, b, 4 * sizeof(double));
-                        if (a != 0) {
-                            printf("\n    set_widget_color(ui->elem[%i], %i, %i,"
+                        if (a != 0 && preview) {
+                            xstring_printf(out, "color\te%i\t%i\t%i\t%.3f\t%.3f\t%.3f\t%.3f\n",
+                                                    x, j, k, b[0], b[1], b[2], b[3]);
+                        } else if (a != 0) {
+                            xstring_printf(out, "\n    set_widget_color(ui->elem[%i], %i, %i,"
                                     "%.3f, %.3f, %.3f, %.3f);\n", x, j, k, b[0], b[1], b[2], b[3]);
                         }
                         x++;
@@ -361,7 +452,139 @@ int format(float value) {
     return l-1;
 }
 
-void print_list(XUiDesigner *designer) {
+// in startup image mode the pngs come packed into atlas pages of decoded pixels
+static int atlas_frame(XUiDesigner *designer, XUiAtlas *atlas, const char* image) {
+    if (designer->run_test || !atlas->entries) return -1;
+    return atlas_find(atlas, shared_image(designer, image));
+}
+
+static void print_atlas_pages(XUiAtlas *atlas, XUiString *out) {
+    if (!atlas->pages) return;
+    int i = 0;
+    xstring_printf(out, "    cairo_surface_t *atlas[%i] = {\n", atlas->pages);
+    for (;i<atlas->pages;i++) {
+        xstring_printf(out, "        surface_from_image_data(&xui_atlas%i),\n", i);
+    }
+    xstring_printf(out, "    };\n\n");
+}
+
+static void print_atlas(XUiAtlas *atlas, XUiString *out) {
+    int i = 0;
+    for (;i<atlas->pages;i++) {
+        xstring_printf(out, "#include \"../resources/xui_atlas%i.h\"\n", i);
+    }
+    xstring_printf(out, "\nstatic const AtlasFrame xui_atlas_frame[] = {\n");
+    for (i=0;i<atlas->entries;i++) {
+        AtlasEntry *e = &atlas->entry[i];
+        char* tmp = strdup(e->image);
+        xstring_printf(out, "    {%i, %i, %i, %i, %i}, // %s\n", e->page, e->x, e->y,
+                                        e->width, e->height, basename(tmp));
+        free(tmp);
+    }
+    xstring_printf(out, "};\n\n");
+}
+
+// the widget gets its frame from the atlas, nothing to inflate on instantiate
+static void print_load_atlas_image(const char* widget, int index, int frame,
+                                                bool scaled, XUiString *out) {
+    if (index < 0) {
+        xstring_printf(out, "    load_atlas_image(%s, atlas, &xui_atlas_frame[%i], %s);\n",
+                                        widget, frame, scaled ? "true" : "false");
+    } else {
+        xstring_printf(out, "    load_atlas_image(%s[%i], atlas, &xui_atlas_frame[%i], %s);\n",
+                                        widget, index, frame, scaled ? "true" : "false");
+    }
+}
+
+// layout table mode, the wrapper creates the widgets from static descriptors
+static bool layout_table(XUiDesigner *designer) {
+    return !designer->run_test && adj_get_value(designer->layout_table->adj);
+}
+
+// one descriptor for each ui->widget[], in the order and with the ports print_list() uses
+static void print_widget_table(XUiDesigner *designer, XUiAtlas *atlas, int MIDI_PORT, XUiString *out) {
+    int p = designer->lv2c.audio_input + designer->lv2c.audio_output +
+        designer->lv2c.midi_input + designer->lv2c.midi_output;
+    XUiString rows;
+    xstring_init(&rows);
+    int i = 0;
+    int j = 0;
+    for (;i<MAX_CONTROLS;i++) {
+        if (designer->controls[i].wid == NULL ||
+                designer->controls[i].is_audio_output || designer->controls[i].is_audio_input ||
+                designer->controls[i].is_atom_output || designer->controls[i].is_atom_input ||
+                designer->controls[i].is_type == IS_FRAME ||
+                designer->controls[i].is_type == IS_IMAGE ||
+                designer->controls[i].is_type == IS_TABBOX) {
+            continue;
+        }
+        Widget_t * wid = designer->controls[i].wid;
+        bool tab = designer->controls[i].in_tab > 0;
+        int parent = tab ? tab_elem_index(designer, i) : designer->controls[i].in_frame-1;
+        bool range = designer->controls[i].have_adjustment && !designer->controls[i].is_midi_patch;
+        int frame = designer->controls[i].image ? atlas_frame(designer, atlas, designer->controls[i].image) : -1;
+        int sprites = -1;
+        if (frame >= 0 && (designer->controls[i].is_type == IS_VSLIDER ||
+                            designer->controls[i].is_type == IS_HSLIDER)) {
+            sprites = designer->controls[i].slider_image_sprites;
+        } else if (frame >= 0 && designer->controls[i].is_type == IS_KNOB) {
+            sprites = 0;
+        }
+        char *entries = NULL;
+        if (designer->controls[i].is_type == IS_COMBOBOX) {
+            Widget_t *menu = wid->childlist->childs[1];
+            Widget_t* view_port =  menu->childlist->childs[0];
+            ComboBox_t *comboboxlist = (ComboBox_t*)view_port->parent_struct;
+            xstring_printf(out, "static const char *const xui_entries_%i[] = {", j);
+            unsigned int ka = 0;
+            for(; ka<comboboxlist->list_size;ka++) {
+                xstring_printf(out, "\"%s\", ", comboboxlist->list_names[ka]);
+            }
+            xstring_printf(out, "NULL};\n");
+            asprintf(&entries, "xui_entries_%i", j);
+        }
+        xstring_printf(&rows, "    {%s, %i, %s, %i, %i, \"%s\", %i, %i, %i, %i, ",
+            designer->controls[i].type, parent, tab ? "true" : "false", lazy_tab_page(designer, i),
+            designer->controls[i].is_midi_patch ? -1 : designer->is_project ? designer->is_faust_file ?
+            designer->controls[i].port_index : p : designer->controls[i].port_index,
+            wid->label, wid->x, wid->y, wid->width, wid->height);
+        if (range) {
+            xstring_printf(&rows, "true, %.*f, %.*f, %.*f, %.*f, %s, ",
+                format(adj_get_std_value(wid->adj)), adj_get_std_value(wid->adj),
+                format(adj_get_min_value(wid->adj)), adj_get_min_value(wid->adj),
+                format(adj_get_max_value(wid->adj)), adj_get_max_value(wid->adj),
+                format(wid->adj->step), wid->adj->step,
+                parse_adjusment_type(wid->adj->type));
+        } else {
+            xstring_printf(&rows, "false, 0, 0, 0, 0, CL_NONE, ");
+        }
+        xstring_printf(&rows, "%i, %i, %s},\n", frame, sprites, entries ? entries : "NULL");
+        free(entries);
+        if (designer->controls[i].is_midi_patch && MIDI_PORT > -1) p--;
+        j++;
+        p++;
+    }
+    xstring_printf(out, "\nstatic const WidgetDescriptor xui_widgets[] = {\n");
+    xstring_append_len(out, rows.str, rows.len);
+    xstring_printf(out, "};\n");
+    xstring_reset(&rows);
+    check_for_Widget_colors(designer, COLORS_TABLE, &rows, NULL);
+    if (rows.len) {
+        xstring_printf(out, "\nstatic const ColorDescriptor xui_widget_colors[] = {\n");
+        xstring_append_len(out, rows.str, rows.len);
+        xstring_printf(out, "};\n");
+    }
+    xstring_printf(out, "\nstatic const WidgetTable xui_table = {\n"
+        "    xui_widgets, sizeof(xui_widgets)/sizeof(xui_widgets[0]),\n"
+        "    %s, %s,\n"
+        "    %s\n"
+        "};\n\n", rows.len ? "xui_widget_colors" : "NULL",
+        rows.len ? "sizeof(xui_widget_colors)/sizeof(xui_widget_colors[0])" : "0",
+        atlas->entries ? "xui_atlas_frame" : "NULL");
+    xstring_free(&rows);
+}
+
+void print_list(XUiDesigner *designer, XUiString *out) {
     int i = 0;
     int j = 0;
     int k = 0;
@@ -369,6 +592,8 @@ void print_list(XUiDesigner *designer) {
     int p = designer->lv2c.audio_input + designer->lv2c.audio_output +
         designer->lv2c.midi_input + designer->lv2c.midi_output;
     bool have_image = false;
+    XUiAtlas atlas;
+    atlas_init(&atlas);
     bool have_atom_in = false;
     bool have_atom_out = false;
     bool have_midi_in = false;
@@ -407,6 +632,19 @@ void print_list(XUiDesigner *designer) {
             have_atom_out = true;
         }
     }
+    bool table = layout_table(designer);
+    // widgets on hidden tab pages could wait until their page gets shown
+    int tab_count = l;
+    bool lazy_tabs = false;
+    bool lazy_page[tab_count+1];
+    memset(lazy_page, 0, (tab_count+1)*sizeof(bool));
+    for (i=0;i<MAX_CONTROLS;i++) {
+        int page = designer->controls[i].wid != NULL ? lazy_tab_page(designer, i) : -1;
+        if (page >= 0 && page < tab_count) {
+            lazy_page[page] = true;
+            lazy_tabs = true;
+        }
+    }
     i = 0;
     int m = 0;
     for (;i<MAX_CONTROLS;i++) {
@@ -426,14 +664,16 @@ void print_list(XUiDesigner *designer) {
         MIDI_PORT = designer->MIDIPORT;
     }
     if (j) {
-        printf ("\n#define CONTROLS %i\n", j);
-        printf ("\n#define GUI_ELEMENTS %i\n", k);
-        printf ("\n#define TAB_ELEMENTS %i\n\n", l);
-        printf ("\n#define PLUGIN_UI_URI \"%s\"\n\n",designer->lv2c.ui_uri);
-        printf ("\n#include \"lv2_plugin.h\"\n\n");
+        // test builds link against the ui_test.cc object built with the fixed sizes
+        xstring_printf(out, "\n#define CONTROLS %i\n", designer->run_test ? TEST_CONTROLS : j);
+        xstring_printf(out, "\n#define GUI_ELEMENTS %i\n", designer->run_test ? TEST_GUI_ELEMENTS : k);
+        xstring_printf(out, "\n#define TAB_ELEMENTS %i\n\n", designer->run_test ? TEST_TAB_ELEMENTS : l);
+        xstring_printf(out, "\n#define PLUGIN_UI_URI \"%s\"\n\n",designer->lv2c.ui_uri);
+        if (lazy_tabs) xstring_printf(out, "\n#define LAZY_TAB_PAGES\n\n");
+        xstring_printf(out, "\n#include \"lv2_plugin.h\"\n\n");
     }
     if (have_atom_in || have_atom_out) {
-        printf("#ifdef USE_ATOM\n");
+        xstring_printf(out, "#ifdef USE_ATOM\n");
     }
     i = 0;
     for (;i<MAX_CONTROLS;i++) {
@@ -446,7 +686,7 @@ void print_list(XUiDesigner *designer) {
             char *xldl = NULL;
             asprintf(&xldl, "%s", wid->label);
             strtovar(xldl);
-            printf ("\n#define XLV2__%s \"%s\"", xldl, uri);
+            xstring_printf(out, "\n#define XLV2__%s \"%s\"", xldl, uri);
             free(xldl);
         } else if (designer->controls[i].is_atom_patch && designer->controls[i].is_type != IS_FILE_BUTTON) {
             Widget_t * wid = designer->controls[i].wid;
@@ -454,7 +694,7 @@ void print_list(XUiDesigner *designer) {
             char *xldl = NULL;
             asprintf(&xldl, "%s", wid->label);
             strtovar(xldl);
-            printf ("\n#define XLV2__%s \"%s\"", xldl, uri);
+            xstring_printf(out, "\n#define XLV2__%s \"%s\"", xldl, uri);
             free(xldl);
         }
     }
@@ -462,23 +702,28 @@ void print_list(XUiDesigner *designer) {
         have_image = true;
     }
     if (have_atom_in || have_atom_out || have_midi_in) {
-        printf ( "\n#define OBJ_BUF_SIZE 1024\n");
+        xstring_printf(out,  "\n#define OBJ_BUF_SIZE 1024\n");
     }
     if (have_atom_in || have_atom_out) {
-        printf ( "\n\ntypedef struct {\n");
+        int patches = 0;
+        for (i=0;i<MAX_CONTROLS;i++) {
+            if (designer->controls[i].is_atom_patch) patches++;
+        }
+        xstring_printf(out,  "\n#define PATCH_WIDGETS %i\n", patches);
+        xstring_printf(out,  "\n\ntypedef struct {\n");
         i = 0;
         for (;i<MAX_CONTROLS;i++) {
             if (designer->controls[i].is_atom_patch) {
                 char *xldl = NULL;
                 asprintf(&xldl, "%s", designer->controls[i].wid->label);
                 strtovar(xldl);
-                printf ("    LV2_URID %s;\n", xldl);
+                xstring_printf(out, "    LV2_URID %s;\n", xldl);
                 free(xldl);
             }
         }
 
 
-        printf ("    LV2_URID atom_Object;\n"
+        xstring_printf(out, "    LV2_URID atom_Object;\n"
                 "    LV2_URID atom_Int;\n"
                 "    LV2_URID atom_Float;\n"
                 "    LV2_URID atom_Bool;\n"
@@ -494,26 +739,40 @@ void print_list(XUiDesigner *designer) {
                 "    LV2_URID patch_value;\n" );
 
 
-        printf ( "} X11LV2URIs;\n");
+        xstring_printf(out,  "} X11LV2URIs;\n");
         
-        printf ("\ntypedef struct {\n"
+        xstring_printf(out, "\n// patch parameter widgets, sorted by urid for get_widget_from_urid()\n"
+                "typedef struct {\n"
+                "    LV2_URID urid;\n"
+                "    Widget_t *w;\n"
+                "} X11PatchWidget;\n");
+
+        xstring_printf(out, "\ntypedef struct {\n"
                 "    LV2_Atom_Forge forge;\n"
                 "    X11LV2URIs   uris;\n"
+                "    X11PatchWidget patch[PATCH_WIDGETS];\n"
+                "    int patch_count;\n"
                 "    char *filename;\n"
                 "} X11_UI_Private_t;\n");
 
-        printf ("\nstatic inline void map_x11ui_uris(LV2_URID_Map* map, X11LV2URIs* uris) {\n");
+        xstring_printf(out, "\nstatic int compare_patch_widgets(const void *a, const void *b) {\n"
+                "    LV2_URID x = ((const X11PatchWidget*)a)->urid;\n"
+                "    LV2_URID y = ((const X11PatchWidget*)b)->urid;\n"
+                "    return (x > y) - (x < y);\n"
+                "}\n");
+
+        xstring_printf(out, "\nstatic inline void map_x11ui_uris(LV2_URID_Map* map, X11LV2URIs* uris) {\n");
         i = 0;
         for (;i<MAX_CONTROLS;i++) {
             if (designer->controls[i].is_atom_patch) {
                 char *xldl = NULL;
                 asprintf(&xldl, "%s", designer->controls[i].wid->label);
                 strtovar(xldl);
-                printf ("    uris->%s = map->map(map->handle, XLV2__%s);\n", xldl, xldl);
+                xstring_printf(out, "    uris->%s = map->map(map->handle, XLV2__%s);\n", xldl, xldl);
                 free(xldl);
             }
         }
-        printf ("    uris->atom_Object = map->map(map->handle, LV2_ATOM__Object);\n"
+        xstring_printf(out, "    uris->atom_Object = map->map(map->handle, LV2_ATOM__Object);\n"
                 "    uris->atom_Int = map->map(map->handle, LV2_ATOM__Int);\n"
                 "    uris->atom_Float = map->map(map->handle, LV2_ATOM__Float);\n"
                 "    uris->atom_Bool = map->map(map->handle, LV2_ATOM__Bool);\n"
@@ -527,22 +786,26 @@ void print_list(XUiDesigner *designer) {
                 "    uris->patch_Set = map->map(map->handle, LV2_PATCH__Set);\n"
                 "    uris->patch_property = map->map(map->handle, LV2_PATCH__property);\n"
                 "    uris->patch_value = map->map(map->handle, LV2_PATCH__value);\n");
-        printf ("}\n");
-        printf ("#endif\n\n");
+        xstring_printf(out, "}\n");
+        xstring_printf(out, "#endif\n\n");
     }
     if (j) {
         Window w = (Window)designer->ui->widget;
         char *name;
         XFetchName(designer->ui->app->dpy, w, &name);
         
-        if (have_image && !designer->run_test) printf ("\n#include \"xresources.h\"\n\n");
-        print_colors(designer);
-        printf ("#include \"%s\"\n\n\n"
-        , designer->run_test? "ui_test.cc": "lv2_plugin.cc");
+        if (have_image && !designer->run_test) xstring_printf(out, "\n#include \"xresources.h\"\n\n");
+        if (have_image && !designer->run_test && adj_get_value(designer->startup_images->adj)) {
+            atlas_collect(designer, &atlas);
+            if (atlas.entries) print_atlas(&atlas, out);
+        }
+        print_colors(designer, out);
+        xstring_printf(out, "%s\n\n\n", designer->run_test ?
+            "#ifndef XUI_TEST_OBJECT\n#include \"ui_test.cc\"\n#endif" : "#include \"lv2_plugin.cc\"");
         
         if (have_midi_in && MIDI_PORT > -1) {
-            printf ("#ifdef USE_MIDI\n");
-            printf("static void send_midi_data(Widget_t *w, const int *key, const int control) {\n"
+            xstring_printf(out, "#ifdef USE_MIDI\n");
+            xstring_printf(out, "static void send_midi_data(Widget_t *w, const int *key, const int control) {\n"
             "    X11_UI *ui = (X11_UI*) w->parent_struct;\n"
             "    MidiKeyboard *keys = (MidiKeyboard*)ui->widget[%i]->private_struct;\n"
             "    uint8_t obj_buf[OBJ_BUF_SIZE];\n"
@@ -561,31 +824,31 @@ void print_list(XUiDesigner *designer) {
             "                       ui->atom_eventTransfer, msg);\n"
             "}\n\n", MIDIKEYBOARD, MIDI_PORT);
 
-            printf("static void send_all_notes_off(Widget_t *w, const int *value){\n"
+            xstring_printf(out, "static void send_all_notes_off(Widget_t *w, const int *value){\n"
             "        X11_UI *ui = (X11_UI*) w->parent_struct;\n"
             "        int key = 120;\n"
             "        send_midi_data(ui->widget[%i], &key, 0xB0);\n"
             "}\n\n", MIDIKEYBOARD);
 
-            printf("static void xkey_press(void *w_, void *key_, void *user_data) {\n"
+            xstring_printf(out, "static void xkey_press(void *w_, void *key_, void *user_data) {\n"
             "        Widget_t *w = (Widget_t*)w_;\n"
             "        X11_UI *ui = (X11_UI*) w->parent_struct;\n"
             "        ui->widget[%i]->func.key_press_callback(ui->widget[%i], key_, user_data);\n"
             "}\n\n", MIDIKEYBOARD, MIDIKEYBOARD);
 
-            printf("static void xkey_release(void *w_, void *key_, void *user_data) {\n"
+            xstring_printf(out, "static void xkey_release(void *w_, void *key_, void *user_data) {\n"
             "        Widget_t *w = (Widget_t*)w_;\n"
             "        X11_UI *ui = (X11_UI*) w->parent_struct;\n"
             "        ui->widget[%i]->func.key_release_callback(ui->widget[%i], key_, user_data);\n"
             "}\n\n", MIDIKEYBOARD, MIDIKEYBOARD);
             
-            printf("#endif\n");
+            xstring_printf(out, "#endif\n");
         }
         
         if (have_atom_in) {
-            printf ("#ifdef USE_ATOM\n");
+            xstring_printf(out, "#ifdef USE_ATOM\n");
 
-            printf ("\nstatic inline LV2_Atom* write_set_file(LV2_Atom_Forge* forge, const LV2_URID control,\n"
+            xstring_printf(out, "\nstatic inline LV2_Atom* write_set_file(LV2_Atom_Forge* forge, const LV2_URID control,\n"
                     "                        const X11LV2URIs* uris, const char* filename) {\n"
                     "    LV2_Atom_Forge_Frame frame;\n"
                     "    LV2_Atom* set = (LV2_Atom*)lv2_atom_forge_object(\n"
@@ -598,7 +861,7 @@ void print_list(XUiDesigner *designer) {
                     "    return set;\n"
                     "}\n");
 
-           printf ("\nstatic void file_load_response(void *w_, void* user_data) {\n"
+           xstring_printf(out, "\nstatic void file_load_response(void *w_, void* user_data) {\n"
                     "    Widget_t *w = (Widget_t*)w_;\n"
                     "    Widget_t *p = (Widget_t*)w->parent;\n"
                     "    X11_UI *ui = (X11_UI*) p->parent_struct;\n"
@@ -621,7 +884,7 @@ void print_list(XUiDesigner *designer) {
                     "    }\n"
                     "}\n", designer->lv2c.atom_input_port);
 
-           printf ("\nvoid send_controller_message(Widget_t *w, const LV2_URID control) {\n"
+           xstring_printf(out, "\nvoid send_controller_message(Widget_t *w, const LV2_URID control) {\n"
                     "    Widget_t *p = (Widget_t*)w->parent;\n"
                     "    X11_UI *ui = (X11_UI*) p->parent_struct;\n"
                     "    X11_UI_Private_t *ps = (X11_UI_Private_t*)ui->private_ptr;\n"
@@ -662,22 +925,29 @@ void print_list(XUiDesigner *designer) {
                     "    }\n"
                     "}\n", designer->lv2c.atom_input_port);
 
-            printf ("\nstatic void dummy_callback(void *w_, void* user_data) {\n"
+            xstring_printf(out, "\nstatic void dummy_callback(void *w_, void* user_data) {\n"
                     "}\n");
 
-            printf ("\nvoid set_ctl_val_from_host(Widget_t *w, float value) {\n"
+            xstring_printf(out, "\nvoid set_ctl_val_from_host(Widget_t *w, float value) {\n"
                     "    xevfunc store = w->func.value_changed_callback;\n"
                     "    w->func.value_changed_callback = dummy_callback;\n"
                     "    adj_set_value(w->adj, value);\n"
                     "    w->func.value_changed_callback = *(*store);\n"
                     "}\n");
 
-            printf("#endif\n");
+            xstring_printf(out, "#endif\n");
         }
         if (have_atom_out) {
             
         }
-        printf ("\nvoid plugin_value_changed(X11_UI *ui, Widget_t *w, PortIndex index) {\n"
+        if (table) print_widget_table(designer, &atlas, MIDI_PORT, out);
+        if (lazy_tabs) {
+            xstring_printf(out, "\n// widgets of the hidden tab pages, created when the page gets shown\n");
+            for (i=0;i<tab_count;i++) {
+                if (lazy_page[i]) xstring_printf(out, "static void create_tab_page_%i(X11_UI *ui, float scale);\n", i);
+            }
+        }
+        xstring_printf(out, "\nvoid plugin_value_changed(X11_UI *ui, Widget_t *w, PortIndex index) {\n"
         "    // do special stuff when needed\n"
         "}\n\n"
         "void plugin_set_window_size(int *w,int *h,const char * plugin_uri, float scale) {\n"
@@ -691,8 +961,10 @@ void print_list(XUiDesigner *designer) {
         "    set_costum_theme(ui->win);\n"
         , designer->ui->width, designer->ui->height, name? name:"Test");
 
+        print_atlas_pages(&atlas, out);
+
         if (have_midi_in && MIDI_PORT > -1) {
-                printf ("#ifdef USE_MIDI\n"
+                xstring_printf(out, "#ifdef USE_MIDI\n"
                 "    XSelectInput(ui->win->app->dpy, ui->win->widget,StructureNotifyMask|ExposureMask|KeyPressMask \n"
                 "        |EnterWindowMask|LeaveWindowMask|ButtonReleaseMask|KeyReleaseMask\n"
                 "        |ButtonPressMask|Button1MotionMask|PointerMotionMask);\n"
@@ -704,34 +976,38 @@ void print_list(XUiDesigner *designer) {
 
         if (designer->image != NULL) {
             if (designer->run_test) {
-                printf ("    load_bg_image(ui,\"%s\");\n", designer->image);
+                xstring_printf(out, "    load_bg_image(ui,\"%s\");\n", designer->image);
             } else {
-                char* tmp = strdup(designer->image);
+                char* tmp = strdup(shared_image(designer, designer->image));
                 char * xldl = strdup(basename(tmp));
                 strdecode(xldl, ".", "_");
                 strdecode(xldl, "-", "_");
                 strdecode(xldl, " ", "_");
                 strtovar(xldl);
-                if (strstr(designer->image, ".png")) {
-                    printf ("    widget_get_scaled_png(ui->win, LDVAR(%s));\n", xldl);
+                int frame = atlas_frame(designer, &atlas, designer->image);
+                if (frame >= 0) {
+                    print_load_atlas_image("ui->win", -1, frame, true, out);
+                } else if (strstr(designer->image, ".png")) {
+                    xstring_printf(out, "    widget_get_scaled_png(ui->win, LDVAR(%s));\n", xldl);
                 } else if (strstr(designer->image, ".svg")) {
-                    printf ("    widget_get_scaled_svg(ui->win, %s);\n", xldl);
+                    xstring_printf(out, "    widget_get_scaled_svg(ui->win, %s);\n", xldl);
                 }
                 free(xldl);
                 xldl = NULL;
                 free(tmp);
                 tmp = NULL;
-                //printf ("    load_bg_image(ui,\"./resources/%s\");\n", basename(designer->image));
+                //xstring_printf(out, "    load_bg_image(ui,\"./resources/%s\");\n", basename(designer->image));
             }
         }
 
         if (have_atom_in || have_atom_out) {
-            printf ("\n#ifdef USE_ATOM\n"
+            xstring_printf(out, "\n#ifdef USE_ATOM\n"
                     "    X11_UI_Private_t *ps =(X11_UI_Private_t*)malloc(sizeof(X11_UI_Private_t));\n"
                     "    ui->private_ptr = (void*)ps;\n"
                     "    map_x11ui_uris(ui->map, &ps->uris);\n"
                     "    lv2_atom_forge_init(&ps->forge, ui->map);\n"
                     "    const X11LV2URIs* uris = &ps->uris;\n"
+                    "    ps->patch_count = 0;\n"
                     "    ps->filename = strdup(\"None\");\n" 
                     "#endif\n\n");
         }
@@ -744,42 +1020,53 @@ void print_list(XUiDesigner *designer) {
     l = 0;
     int ttb[k] ;
     memset(ttb, 0, k*sizeof(int));
+    XUiString pages[tab_count+1];
+    for (i=0;i<=tab_count;i++) {
+        xstring_init(&pages[i]);
+    }
+    // in table mode the per widget code runs after the table created the widgets
+    XUiString late;
+    xstring_init(&late);
+    i = 0;
     for (;i<MAX_CONTROLS;i++) {
         if (designer->controls[i].wid != NULL) {
             if (designer->controls[i].is_type == IS_FRAME || designer->controls[i].is_type == IS_IMAGE ) {
-                printf ("    ui->elem[%i] = %s (ui->elem[%i], ui->win, %i, \"%s\", ui, %i,  %i, %i * scale, %i * scale);\n", 
+                xstring_printf(out, "    ui->elem[%i] = %s (ui->elem[%i], ui->win, %i, \"%s\", ui, %i,  %i, %i * scale, %i * scale);\n",
                     j, designer->controls[i].type, j,
                     designer->is_project ? p : designer->controls[i].port_index, designer->controls[i].wid->label,
                     designer->controls[i].wid->x, designer->controls[i].wid->y,
                     designer->controls[i].wid->width, designer->controls[i].wid->height);
                 if (designer->controls[i].image != NULL ) {
                     if (designer->run_test) {
-                        printf ("    load_controller_image(ui->elem[%i], \"%s\");\n",
+                        xstring_printf(out, "    load_controller_image(ui->elem[%i], \"%s\");\n",
                                             j, designer->controls[i].image);
                     } else {
-                        char* tmp = strdup(designer->controls[i].image);
+                        char* tmp = strdup(shared_image(designer, designer->controls[i].image));
                         char * xldl = strdup(basename(tmp));
                         strdecode(xldl, ".", "_");
                         strdecode(xldl, "-", "_");
                         strdecode(xldl, " ", "_");
                         strtovar(xldl);
-                        if (strstr(designer->controls[i].image, ".png")) {
-                            printf ("    widget_get_scaled_png(ui->elem[%i], LDVAR(%s));\n",
+                        int frame = atlas_frame(designer, &atlas, designer->controls[i].image);
+                        if (frame >= 0) {
+                            print_load_atlas_image("ui->elem", j, frame, true, out);
+                        } else if (strstr(designer->controls[i].image, ".png")) {
+                            xstring_printf(out, "    widget_get_scaled_png(ui->elem[%i], LDVAR(%s));\n",
                                     j, xldl);
                         } else if (strstr(designer->controls[i].image, ".svg")) {
-                            printf ("    widget_get_scaled_svg(ui->widget[%i], %s);\n", j, xldl);
+                            xstring_printf(out, "    widget_get_scaled_svg(ui->widget[%i], %s);\n", j, xldl);
                         }
                         free(xldl);
                         xldl = NULL;
                         free(tmp);
                         tmp = NULL;
-                       // printf ("    load_controller_image(ui->elem[%i], \"./resources/%s\");\n",
+                       // xstring_printf(out, "    load_controller_image(ui->elem[%i], \"./resources/%s\");\n",
                        //                         j, basename(designer->controls[i].image));
                     }
                 }
                 j++;
             } else if (designer->controls[i].is_type == IS_TABBOX) {
-                printf ("    ui->elem[%i] = %s (ui->elem[%i], ui->win, %i, \"%s\", ui, %i,  %i, %i * scale, %i * scale);\n", 
+                xstring_printf(out, "    ui->elem[%i] = %s (ui->elem[%i], ui->win, %i, \"%s\", ui, %i,  %i, %i * scale, %i * scale);\n",
                     j, designer->controls[i].type, j,
                     designer->is_project ? p : designer->controls[i].port_index, designer->controls[i].wid->label,
                     designer->controls[i].wid->x, designer->controls[i].wid->y,
@@ -789,11 +1076,11 @@ void print_list(XUiDesigner *designer) {
                 int t = 0;
                 for(;t<elem;t++) {
                     Widget_t *wi = designer->controls[i].wid->childlist->childs[t];
-                    printf ("    ui->tab_elem[%i] = add_lv2_tab (ui->tab_elem[%i], ui->elem[%i], -1, \"%s\", ui);\n", 
+                    xstring_printf(out, "    ui->tab_elem[%i] = add_lv2_tab (ui->tab_elem[%i], ui->elem[%i], -1, \"%s\", ui);\n",
                         l, l, j, wi->label);
                     l++;
                 }
-                printf ("\n");
+                xstring_printf(out, "\n");
                 j++;
             }
             
@@ -808,11 +1095,13 @@ void print_list(XUiDesigner *designer) {
                 continue;
             }
             Widget_t * wid = designer->controls[i].wid;
+            int page = lazy_tab_page(designer, i);
+            XUiString *dest = page >= 0 ? &pages[page] : table ? &late : out;
             if (designer->controls[i].is_type == IS_FRAME ||
                 designer->controls[i].is_type == IS_IMAGE ||
                 designer->controls[i].is_type == IS_TABBOX) {
                 continue;
-            } else {
+            } else if (!table) {
                 char* parent = NULL;
                 if (designer->controls[i].in_tab) {
                     int atb = ttb[designer->controls[i].in_frame-1];
@@ -821,7 +1110,7 @@ void print_list(XUiDesigner *designer) {
                     designer->controls[i].in_frame ? asprintf(&parent,"ui->elem[%i]", designer->controls[i].in_frame-1) :
                         asprintf(&parent,"%s", "ui->win");
                 }
-                printf ("    ui->widget[%i] = %s (ui->widget[%i], %s, %i, \"%s\", ui, %i,  %i, %i * scale, %i * scale);\n", 
+                xstring_printf(dest, "    ui->widget[%i] = %s (ui->widget[%i], %s, %i, \"%s\", ui, %i,  %i, %i * scale, %i * scale);\n",
                     j, designer->controls[i].type, j, parent,
                     designer->controls[i].is_midi_patch ? -1 : designer->is_project ? designer->is_faust_file ?
                     designer->controls[i].port_index : p : designer->controls[i].port_index,
@@ -832,34 +1121,41 @@ void print_list(XUiDesigner *designer) {
             }
             if (designer->controls[i].is_atom_patch ) {
                 //const char* uri = (const char*) wid->parent_struct;
-                printf("#ifdef USE_ATOM\n");
+                xstring_printf(dest, "#ifdef USE_ATOM\n");
                 char* xldl = NULL;
                 asprintf(&xldl, "%s", wid->label);
                 strtovar(xldl);
-                printf("    ui->widget[%i]->parent_struct = (void*)&uris->%s;\n", j, xldl);
+                xstring_printf(dest, "    ui->widget[%i]->parent_struct = (void*)&uris->%s;\n", j, xldl);
+                xstring_printf(dest, "    ps->patch[ps->patch_count].urid = uris->%s;\n"
+                        "    ps->patch[ps->patch_count++].w = ui->widget[%i];\n", xldl, j);
                 free(xldl);
                 if (designer->controls[i].is_type == IS_FILE_BUTTON ) {
-                    printf("    ui->widget[%i]->func.user_callback = controller_callback;\n", j);
+                    xstring_printf(dest, "    ui->widget[%i]->func.user_callback = controller_callback;\n", j);
                 } else {
-                    printf("    ui->widget[%i]->func.value_changed_callback = controller_callback;\n", j);
+                    xstring_printf(dest, "    ui->widget[%i]->func.value_changed_callback = controller_callback;\n", j);
                 }
-                printf("#endif\n");
+                xstring_printf(dest, "#endif\n");
             }
-            if (designer->controls[i].image != NULL ) {
+            // the table loads atlas frames itself
+            if (designer->controls[i].image != NULL && !(table &&
+                    atlas_frame(designer, &atlas, designer->controls[i].image) >= 0)) {
                 if (designer->run_test) {
-                    printf ("    load_controller_image(ui->widget[%i], \"%s\");\n",
+                    xstring_printf(dest, "    load_controller_image(ui->widget[%i], \"%s\");\n",
                             j, designer->controls[i].image);
                 } else {
-                    char* tmp = strdup(designer->controls[i].image);
+                    char* tmp = strdup(shared_image(designer, designer->controls[i].image));
                     char * xldl = strdup(basename(tmp));
                     strdecode(xldl, ".", "_");
                     strdecode(xldl, "-", "_");
                     strdecode(xldl, " ", "_");
                     strtovar(xldl);
-                    if (strstr(designer->controls[i].image, ".png")) {
-                        printf ("    widget_get_png(ui->widget[%i], LDVAR(%s));\n", j, xldl);
+                    int frame = atlas_frame(designer, &atlas, designer->controls[i].image);
+                    if (frame >= 0) {
+                        print_load_atlas_image("ui->widget", j, frame, false, dest);
+                    } else if (strstr(designer->controls[i].image, ".png")) {
+                        xstring_printf(dest, "    widget_get_png(ui->widget[%i], LDVAR(%s));\n", j, xldl);
                     } else if (strstr(designer->controls[i].image, ".svg")) {
-                        printf ("    widget_get_svg(ui->widget[%i], %s);\n", j, xldl);
+                        xstring_printf(dest, "    widget_get_svg(ui->widget[%i], %s);\n", j, xldl);
                     }
                     free(xldl);
                     xldl = NULL;
@@ -868,21 +1164,25 @@ void print_list(XUiDesigner *designer) {
                 }
                 if (designer->controls[i].is_type == IS_VSLIDER ||
                         designer->controls[i].is_type == IS_HSLIDER) {
-                    printf ("    set_slider_image_frame_count(ui->widget[%i], %i);\n",j,
+                    xstring_printf(dest, "    set_slider_image_frame_count(ui->widget[%i], %i);\n",j,
                         designer->controls[i].slider_image_sprites);
+                    xstring_printf(dest, "    slice_controller_image(ui->widget[%i], %i);\n",j,
+                        designer->controls[i].slider_image_sprites);
+                } else if (designer->controls[i].is_type == IS_KNOB) {
+                    xstring_printf(dest, "    slice_controller_image(ui->widget[%i], 0);\n",j);
                 }
             }
-            if (designer->controls[i].is_type == IS_COMBOBOX) {
+            if (designer->controls[i].is_type == IS_COMBOBOX && !table) {
                 Widget_t *menu = wid->childlist->childs[1];
                 Widget_t* view_port =  menu->childlist->childs[0];
                 ComboBox_t *comboboxlist = (ComboBox_t*)view_port->parent_struct;
                 unsigned int ka = 0;
                 for(; ka<comboboxlist->list_size;ka++) {
-                    printf ("    combobox_add_entry (ui->widget[%i], \"%s\");\n", j, comboboxlist->list_names[ka]);
+                    xstring_printf(dest, "    combobox_add_entry (ui->widget[%i], \"%s\");\n", j, comboboxlist->list_names[ka]);
                 }
             }
-            if (designer->controls[i].have_adjustment && !designer->controls[i].is_midi_patch) {
-                printf ("    set_adjustment(ui->widget[%i]->adj, %.*f, %.*f, %.*f, %.*f, %.*f, %s);\n", 
+            if (designer->controls[i].have_adjustment && !designer->controls[i].is_midi_patch && !table) {
+                xstring_printf(dest, "    set_adjustment(ui->widget[%i]->adj, %.*f, %.*f, %.*f, %.*f, %.*f, %s);\n",
                     j, format(adj_get_std_value(wid->adj)),adj_get_std_value(wid->adj),
                     format(adj_get_std_value(wid->adj)), adj_get_std_value(wid->adj),
                     format(adj_get_min_value(wid->adj)),adj_get_min_value(wid->adj),
@@ -891,7 +1191,7 @@ void print_list(XUiDesigner *designer) {
                     parse_adjusment_type(wid->adj->type));
             }
             if (designer->controls[i].is_midi_patch && MIDI_PORT > -1) {
-                printf ("#ifdef USE_MIDI\n"
+                xstring_printf(dest, "#ifdef USE_MIDI\n"
                         "    MidiKeyboard *keys = (MidiKeyboard*)ui->widget[%i]->private_struct;\n"
                         "    keys->mk_send_note = send_midi_data;\n"
                         "    keys->mk_send_all_sound_off = send_all_notes_off;\n"
@@ -899,13 +1199,13 @@ void print_list(XUiDesigner *designer) {
                 p--;
             }
             if (have_midi_in && MIDI_PORT > -1 && ! designer->controls[i].is_midi_patch) {
-                    printf ("#ifdef USE_MIDI\n"
+                    xstring_printf(dest, "#ifdef USE_MIDI\n"
                             "    ui->widget[%i]->func.key_press_callback = xkey_press;\n"
                             "    ui->widget[%i]->func.key_release_callback = xkey_release;\n"
                             "#endif\n", j, j);
 
             }
-            printf ("\n");
+            xstring_printf(dest, "\n");
             if (designer->controls[i].is_type != IS_FRAME) {
                 j++;
                 p++;
@@ -915,27 +1215,79 @@ void print_list(XUiDesigner *designer) {
             }
         }
     }
-    check_for_elem_colors(designer);
-    check_for_Widget_colors(designer);
-    printf ("}\n\n"
-    "void plugin_cleanup(X11_UI *ui) {\n");
+    if (table) {
+        xstring_printf(out, "    create_widget_table(ui, &xui_table, %s, -1, scale);\n\n",
+                                                    atlas.pages ? "atlas" : "NULL");
+        xstring_append_len(out, late.str, late.len);
+    }
+    xstring_free(&late);
     if (have_atom_in || have_atom_out) {
-        printf ("#ifdef USE_ATOM\n"
+        xstring_printf(out, "#ifdef USE_ATOM\n"
+                "    qsort(ps->patch, ps->patch_count, sizeof(X11PatchWidget), compare_patch_widgets);\n"
+                "#endif\n\n");
+    }
+    for (i=0;i<tab_count;i++) {
+        if (lazy_page[i]) xstring_printf(out, "    set_lazy_tab_page(ui, %i, create_tab_page_%i);\n", i, i);
+    }
+    check_for_elem_colors(designer, false, out);
+    if (!table) check_for_Widget_colors(designer, COLORS_CODE, out, pages);
+    for (i=0;i<atlas.pages;i++) {
+        xstring_printf(out, "    cairo_surface_destroy(atlas[%i]);\n", i);
+    }
+    xstring_printf(out, "}\n\n");
+    for (i=0;i<tab_count;i++) {
+        if (!lazy_page[i]) continue;
+        xstring_printf(out, "static void create_tab_page_%i(X11_UI *ui, float scale) {\n", i);
+        if (have_atom_in || have_atom_out) {
+            xstring_printf(out, "#ifdef USE_ATOM\n"
+                    "    X11_UI_Private_t *ps = (X11_UI_Private_t*)ui->private_ptr;\n"
+                    "    const X11LV2URIs* uris = &ps->uris;\n"
+                    "#endif\n\n");
+        }
+        print_atlas_pages(&atlas, out);
+        if (table) {
+            xstring_printf(out, "    create_widget_table(ui, &xui_table, %s, %i, scale);\n\n",
+                                                    atlas.pages ? "atlas" : "NULL", i);
+        }
+        xstring_append_len(out, pages[i].str, pages[i].len);
+        if (have_atom_in || have_atom_out) {
+            xstring_printf(out, "#ifdef USE_ATOM\n"
+                    "    qsort(ps->patch, ps->patch_count, sizeof(X11PatchWidget), compare_patch_widgets);\n"
+                    "#endif\n");
+        }
+        int a = 0;
+        for (;a<atlas.pages;a++) {
+            xstring_printf(out, "    cairo_surface_destroy(atlas[%i]);\n", a);
+        }
+        xstring_printf(out, "}\n\n");
+    }
+    for (i=0;i<=tab_count;i++) {
+        xstring_free(&pages[i]);
+    }
+    atlas_free(&atlas);
+    xstring_printf(out, "void plugin_cleanup(X11_UI *ui) {\n");
+    if (have_atom_in || have_atom_out) {
+        xstring_printf(out, "#ifdef USE_ATOM\n"
                 "    X11_UI_Private_t *ps = (X11_UI_Private_t*)ui->private_ptr;\n"
                 "    free(ps->filename);\n"
                 "#endif\n");
     }
-    printf ("    // clean up used sources when needed\n"
+    xstring_printf(out, "    // clean up used sources when needed\n"
             "}\n\n");
 
     if (have_atom_in || have_atom_out) {
-        printf ("#ifdef USE_ATOM\n"
+        xstring_printf(out, "#ifdef USE_ATOM\n"
                 "Widget_t *get_widget_from_urid(X11_UI *ui, const LV2_URID urid) {\n"
-                "    int i = 0;\n"
-                "    for(; i<CONTROLS; i++) {\n"
-                "        if (*(const LV2_URID*)ui->widget[i]->parent_struct == urid) {\n"
-                "            return ui->widget[i];\n"
-                "        }\n"
+                "    X11_UI_Private_t *ps = (X11_UI_Private_t*)ui->private_ptr;\n"
+                "    int lo = 0;\n"
+                "    int hi = ps->patch_count;\n"
+                "    while (lo < hi) {\n"
+                "        int mid = (lo + hi) / 2;\n"
+                "        if (ps->patch[mid].urid < urid) lo = mid + 1;\n"
+                "        else hi = mid;\n"
+                "    }\n"
+                "    if (lo < ps->patch_count && ps->patch[lo].urid == urid) {\n"
+                "        return ps->patch[lo].w;\n"
                 "    }\n"
                 "    return NULL;\n"
                 "}\n"
@@ -961,12 +1313,12 @@ void print_list(XUiDesigner *designer) {
                 "}\n"
                 "#endif\n");
     }
-    printf ("\nvoid plugin_port_event(LV2UI_Handle handle, uint32_t port_index,\n"
+    xstring_printf(out, "\nvoid plugin_port_event(LV2UI_Handle handle, uint32_t port_index,\n"
             "                        uint32_t buffer_size, uint32_t format,\n"
             "                        const void * buffer) {\n");
 
     if (have_atom_in || have_atom_out) {
-        printf ("#ifdef USE_ATOM\n"
+        xstring_printf(out, "#ifdef USE_ATOM\n"
                 "    X11_UI* ui = (X11_UI*)handle;\n"
                 "    X11_UI_Private_t *ps = (X11_UI_Private_t*)ui->private_ptr;\n"
                 "    const X11LV2URIs* uris = &ps->uris;\n"
@@ -1013,9 +1365,133 @@ void print_list(XUiDesigner *designer) {
                 "    }\n"
                 "#endif\n");
     }
-    printf ("    // port value change message from host\n"
+    xstring_printf(out, "    // port value change message from host\n"
             "    // do special stuff when needed\n"
             "}\n\n");
 
 }
 
+
+/*---------------------------------------------------------------------
+-----------------------------------------------------------------------    
+            print widget description for the preview runtime
+-----------------------------------------------------------------------
+----------------------------------------------------------------------*/
+
+// one tab separated line for each call the test build would do, xuipreview replays them
+void print_preview(XUiDesigner *designer, XUiString *out) {
+    int i = 0;
+    int j = 0;
+    int k = 0;
+    int l = 0;
+    int p = designer->lv2c.audio_input + designer->lv2c.audio_output +
+        designer->lv2c.midi_input + designer->lv2c.midi_output;
+    for (;i<MAX_CONTROLS;i++) {
+        if (designer->controls[i].wid != NULL && (designer->controls[i].is_type == IS_FRAME ||
+                                                designer->controls[i].is_type == IS_IMAGE ||
+                                                designer->controls[i].is_type == IS_TABBOX)) {
+            k++;
+        }
+    }
+    char *name = NULL;
+    XFetchName(designer->ui->app->dpy, designer->ui->widget, &name);
+    xstring_printf(out, "xuipreview\t1\n");
+    xstring_printf(out, "window\t%i\t%i\t%s\n", designer->ui->width, designer->ui->height,
+                                                            name ? name : "Test");
+    if (name) XFree(name);
+    for (j=0;j<5;j++) {
+        Colors *c = get_color_scheme(designer->ui, j);
+        xstring_printf(out, "theme\t%i", j);
+        int m = 0;
+        for (;m<7;m++) {
+            double *b = get_selected_color(c, m);
+            xstring_printf(out, "\t%.3f\t%.3f\t%.3f\t%.3f", b[0], b[1], b[2], b[3]);
+        }
+        xstring_printf(out, "\n");
+    }
+    if (designer->image != NULL) {
+        xstring_printf(out, "background\t%s\n", designer->image);
+    }
+
+    int ttb[k+1];
+    memset(ttb, 0, (k+1)*sizeof(int));
+    i = 0;
+    j = 0;
+    for (;i<MAX_CONTROLS;i++) {
+        if (designer->controls[i].wid == NULL) continue;
+        Widget_t *wid = designer->controls[i].wid;
+        if (designer->controls[i].is_type == IS_FRAME || designer->controls[i].is_type == IS_IMAGE ||
+                                            designer->controls[i].is_type == IS_TABBOX) {
+            xstring_printf(out, "elem\t%i\t%s\t%i\t%i\t%i\t%i\t%i\t%s\n", j, designer->controls[i].type,
+                designer->is_project ? p : designer->controls[i].port_index,
+                wid->x, wid->y, wid->width, wid->height, wid->label);
+            if (designer->controls[i].is_type == IS_TABBOX) {
+                ttb[j] = l;
+                int t = 0;
+                for(;t<wid->childlist->elem;t++) {
+                    xstring_printf(out, "tab\t%i\t%i\t%s\n", l, j, wid->childlist->childs[t]->label);
+                    l++;
+                }
+            } else if (designer->controls[i].image != NULL) {
+                xstring_printf(out, "image\te%i\t%s\n", j, designer->controls[i].image);
+            }
+            j++;
+        }
+    }
+
+    i = 0;
+    j = 0;
+    for (;i<MAX_CONTROLS;i++) {
+        if (designer->controls[i].wid == NULL) continue;
+        if (designer->controls[i].is_audio_output || designer->controls[i].is_audio_input ||
+            designer->controls[i].is_atom_output || designer->controls[i].is_atom_input ||
+            designer->controls[i].is_type == IS_FRAME || designer->controls[i].is_type == IS_IMAGE ||
+            designer->controls[i].is_type == IS_TABBOX) {
+            continue;
+        }
+        Widget_t *wid = designer->controls[i].wid;
+        char parent[32];
+        if (designer->controls[i].in_tab) {
+            snprintf(parent, sizeof(parent), "t%i",
+                ttb[designer->controls[i].in_frame-1] + designer->controls[i].in_tab-1);
+        } else if (designer->controls[i].in_frame) {
+            snprintf(parent, sizeof(parent), "e%i", designer->controls[i].in_frame-1);
+        } else {
+            snprintf(parent, sizeof(parent), "win");
+        }
+        xstring_printf(out, "widget\t%i\t%s\t%s\t%i\t%i\t%i\t%i\t%i\t%s\n", j,
+            designer->controls[i].type, parent,
+            designer->controls[i].is_midi_patch ? -1 : designer->is_project ? designer->is_faust_file ?
+            designer->controls[i].port_index : p : designer->controls[i].port_index,
+            wid->x, wid->y, wid->width, wid->height, wid->label);
+        if (designer->controls[i].image != NULL) {
+            xstring_printf(out, "image\tw%i\t%s\n", j, designer->controls[i].image);
+            if (designer->controls[i].is_type == IS_VSLIDER ||
+                    designer->controls[i].is_type == IS_HSLIDER) {
+                xstring_printf(out, "frames\tw%i\t%i\n", j, designer->controls[i].slider_image_sprites);
+                xstring_printf(out, "slice\tw%i\t%i\n", j, designer->controls[i].slider_image_sprites);
+            } else if (designer->controls[i].is_type == IS_KNOB) {
+                xstring_printf(out, "slice\tw%i\t0\n", j);
+            }
+        }
+        if (designer->controls[i].is_type == IS_COMBOBOX) {
+            Widget_t *menu = wid->childlist->childs[1];
+            Widget_t* view_port =  menu->childlist->childs[0];
+            ComboBox_t *comboboxlist = (ComboBox_t*)view_port->parent_struct;
+            unsigned int ka = 0;
+            for(; ka<comboboxlist->list_size;ka++) {
+                xstring_printf(out, "entry\tw%i\t%s\n", j, comboboxlist->list_names[ka]);
+            }
+        }
+        if (designer->controls[i].have_adjustment && !designer->controls[i].is_midi_patch) {
+            xstring_printf(out, "adjustment\tw%i\t%f\t%f\t%f\t%f\t%i\n", j,
+                adj_get_std_value(wid->adj), adj_get_min_value(wid->adj),
+                adj_get_max_value(wid->adj), wid->adj->step, (int)wid->adj->type);
+        }
+        if (designer->controls[i].is_midi_patch) p--;
+        j++;
+        p++;
+    }
+    check_for_elem_colors(designer, true, out);
+    check_for_Widget_colors(designer, COLORS_PREVIEW, out, NULL);
+}